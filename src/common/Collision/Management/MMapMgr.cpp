@@ -20,6 +20,7 @@
 #include "Errors.h"
 #include "Log.h"
 #include "MapDefines.h"
+#include <mutex>
 
 namespace MMAP
 {
@@ -288,16 +289,20 @@ namespace MMAP
         }
 
         MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        std::unique_lock<std::shared_mutex> lock(mmap->navMeshQueriesLock);
+        NavMeshQuerySet::iterator queryItr = mmap->navMeshQueries.find(instanceId);
+        if (queryItr == mmap->navMeshQueries.end())
         {
             LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId {:03} instanceId {}", mapId, instanceId);
             return false;
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
+        for (auto& navMeshQuerie : queryItr->second)
+        {
+            dtFreeNavMeshQuery(navMeshQuerie.second);
+        }
 
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
+        mmap->navMeshQueries.erase(queryItr);
         LOG_DEBUG("maps", "MMAP:unloadMapInstance: Unloaded mapId {:03} instanceId {}", mapId, instanceId);
 
         return true;
@@ -323,27 +328,35 @@ namespace MMAP
         }
 
         MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        std::thread::id const threadId = std::this_thread::get_id();
         {
-            // check again after acquiring mutex
-            if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+            std::shared_lock<std::shared_mutex> lock(mmap->navMeshQueriesLock);
+            NavMeshQuerySet::const_iterator queryItr = mmap->navMeshQueries.find(instanceId);
+            if (queryItr != mmap->navMeshQueries.end())
             {
-                // allocate mesh query
-                dtNavMeshQuery* query = dtAllocNavMeshQuery();
-                ASSERT(query);
-
-                if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+                ThreadNavMeshQuerySet::const_iterator threadItr = queryItr->second.find(threadId);
+                if (threadItr != queryItr->second.end())
                 {
-                    dtFreeNavMeshQuery(query);
-                    LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-                    return nullptr;
+                    return threadItr->second;
                 }
-
-                LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-                mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
             }
         }
 
-        return mmap->navMeshQueries[instanceId];
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+
+        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
+            return nullptr;
+        }
+
+        // only this thread may add a query for itself, no need to check again after acquiring mutex
+        LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
+        std::unique_lock<std::shared_mutex> lock(mmap->navMeshQueriesLock);
+        mmap->navMeshQueries[instanceId].emplace(threadId, query);
+        return query;
     }
 }
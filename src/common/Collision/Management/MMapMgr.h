@@ -23,6 +23,7 @@
 #include "DetourExtended.h"
 #include "DetourNavMesh.h"
 #include <shared_mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -41,7 +42,8 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> ThreadNavMeshQuerySet;
+    typedef std::unordered_map<uint32, ThreadNavMeshQuerySet> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
@@ -50,9 +52,12 @@ namespace MMAP
 
         ~MMapData()
         {
-            for (auto& navMeshQuerie : navMeshQueries)
+            for (auto& instanceQueries : navMeshQueries)
             {
-                dtFreeNavMeshQuery(navMeshQuerie.second);
+                for (auto& navMeshQuerie : instanceQueries.second)
+                {
+                    dtFreeNavMeshQuery(navMeshQuerie.second);
+                }
             }
 
             if (navMesh)
@@ -61,8 +66,10 @@ namespace MMAP
             }
         }
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries; // instanceId to query
+        // we have to use single dtNavMeshQuery for every instance and thread, since those are not thread safe
+        // (instances of a map and regions of a continent may be updated by different threads at once)
+        NavMeshQuerySet navMeshQueries; // instanceId to thread to query
+        std::shared_mutex navMeshQueriesLock;
         dtNavMesh* navMesh;
         MMapTileSet loadedTileRefs; // maps [map grid coords] to [dtTile]
     };
@@ -83,7 +90,7 @@ namespace MMAP
         bool unloadMap(uint32 mapId);
         bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-        // the returned [dtNavMeshQuery const*] is NOT threadsafe
+        // the returned [dtNavMeshQuery const*] is NOT threadsafe, it belongs to the calling thread
         dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
         dtNavMesh const* GetNavMesh(uint32 mapId);
 
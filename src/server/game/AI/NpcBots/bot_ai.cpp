@@ -5,9 +5,14 @@
 #include "bot_ai.h"
 #include "bot_Events.h"
 #include "bot_GridNotifiers.h"
+#include "botaoezones.h"
+#include "botdecision.h"
 #include "botdatamgr.h"
 #include "botmgr.h"
 #include "botgearscore.h"
+#include "botgridcache.h"
+#include "bothealtriage.h"
+#include "botscheduler.h"
 #include "botgossip.h"
 #include "botspell.h"
 #include "bottext.h"
@@ -24,6 +29,7 @@
 #include "GameEventMgr.h"
 #include "GameGraveyard.h"
 #include "GameObjectAI.h"
+#include "GameTime.h"
 #include "GossipDef.h"
 #include "GridNotifiersImpl.h"
 #include "InstanceScript.h"
@@ -212,6 +218,11 @@ bot_ai::bot_ai(Creature* creature) : CreatureAI(creature)
     regenTimer = 0;
     m_botSpellInfo = nullptr;
     waitTimer = 0;
+    _hostileScanTick = 0;
+    _hostileScanRange = 0.f;
+    _spellTimeMs = 0;
+    _updateCost = 0;
+    _updateAdmitted = false;
     _moveBehindTimer = 0;
     itemsAutouseTimer = 0;
     _usableItemSlotsMask = 0;
@@ -229,6 +240,10 @@ bot_ai::bot_ai(Creature* creature) : CreatureAI(creature)
     doHealth = false;
     doMana = false;
     //shouldUpdateStats = true;
+    shouldUpdateRatings = false;
+    _gearScoresValid = false;
+    _gearScoresLevel = 0;
+    _gearScoresSpec = 0;
     movepos.m_positionX = 0.f;
     movepos.m_positionY = 0.f;
     movepos.m_positionZ = 0.f;
@@ -270,6 +285,10 @@ bot_ai::bot_ai(Creature* creature) : CreatureAI(creature)
     _baseLevel = 0;
     _travel_node_last = nullptr;
     _travel_node_cur = nullptr;
+    _travelOnly = false;
+    _travelOnlyCheckTimer = 0;
+    _travelOnlyUpdateTimer = 0;
+    _travelOnlyElapsed = 0;
 
     _groupUpdateMask = 0;
     _auraRaidUpdateMask = 0;
@@ -287,13 +306,6 @@ bot_ai::~bot_ai()
 {
     LOG_INFO("scripts", "bot_ai destructor call for {} ({})", me->GetName().c_str(), me->GetEntry());
 
-    while (!_spells.empty())
-    {
-        BotSpellMap::iterator itr = _spells.begin();
-        delete itr->second;
-        _spells.erase(itr);
-    }
-
     for (uint8 i = BOT_SLOT_MAINHAND; i != BOT_INVENTORY_SIZE; ++i)
         if (_equips[i])
             delete _equips[i];
@@ -1352,6 +1364,106 @@ bool bot_ai::IsPointedAnyAttackTarget(Unit const* target) const
 {
     return IsPointedTarget(target, BotMgr::GetOffTankTargetIconFlags() | BotMgr::GetDPSTargetIconFlags() | BotMgr::GetRangedDPSTargetIconFlags());
 }
+//Damage taken is tracked by BotMgr of unit's owner (player itself or bot's master), see Unit::DealDamage
+static uint32 GetOwnerDPSTaken(Unit const* u)
+{
+    Player const* owner = u->GetTypeId() == TYPEID_PLAYER ? u->ToPlayer() :
+        u->IsNPCBot() ? u->ToCreature()->GetBotOwner() : u->GetCharmerOrOwnerPlayerOrPlayerItself();
+    return (owner && owner->GetBotMgr()) ? owner->GetBotMgr()->GetDPSTaken(u) : 0;
+}
+//Collects heal candidates of master's group (or master's bots if not grouped) on bot's map
+//Queue is shared by all healers of the group (see BotHealTriage), so nothing here may depend on this bot's master:
+//distance and pointed target checks are done when claiming
+void bot_ai::_FillHealQueue(BotHealQueue& queue, Group const* pGroup) const
+{
+    Map const* myMap = me->GetMap();
+
+    auto addVehicle = [&](Unit* u) {
+        if (u && me->GetMap() == u->FindMap() &&
+            !(u->GetTypeId() == TYPEID_UNIT && u->ToCreature()->GetCreatureTemplate()->type == CREATURE_TYPE_MECHANICAL) &&
+            !u->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(u) < 95)
+            queue.AddCandidate(u, GetOwnerDPSTaken(u));
+    };
+    auto addBots = [&](BotMap const* bmap) {
+        for (BotMap::const_iterator itr = bmap->begin(); itr != bmap->end(); ++itr)
+        {
+            Unit* u = itr->second;
+            if (!u->IsInWorld() || myMap != u->FindMap())
+                continue;
+
+            queue.AddHealer(u);
+
+            if (u->IsAlive() && !u->HasUnitState(UNIT_STATE_ISOLATED) && !u->ToCreature()->IsTempBot() &&
+                (GetHealthPCT(u) <= 95 || IsTank(u)))
+                queue.AddCandidate(u, GetOwnerDPSTaken(u));
+
+            u = itr->second->GetBotsPet();
+            if (u && myMap == u->FindMap() && u->IsAlive() && !u->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(u) <= 95)
+                queue.AddCandidate(u, GetOwnerDPSTaken(u));
+
+            addVehicle(itr->second->GetVehicleBase());
+        }
+    };
+    auto addControlled = [&](Player const* player) {
+        for (Unit::ControlSet::const_iterator itr = player->m_Controlled.begin(); itr != player->m_Controlled.end(); ++itr)
+        {
+            Unit* u = *itr;
+            if (!u->IsInWorld() || myMap != u->FindMap() || !u->IsAlive() || u->HasUnitState(UNIT_STATE_ISOLATED) ||
+                u->IsTotem() || u->GetEntry() == SHAMAN_EARTH_ELEMENTAL ||
+                (GetHealthPCT(u) > 95 && !IsTank(u)))
+                continue;
+
+            queue.AddCandidate(u, GetOwnerDPSTaken(u));
+        }
+    };
+
+    if (!pGroup)
+    {
+        if (master->IsAlive() && !master->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(master) < 95 && myMap == master->FindMap())
+            queue.AddCandidate(master, GetOwnerDPSTaken(master));
+        addVehicle(master->GetVehicleBase());
+        addBots(master->GetBotMgr()->GetBotMap());
+        addControlled(master);
+    }
+    else
+    {
+        for (GroupReference const* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
+        {
+            Player* tPlayer = itr->GetSource();
+            if (tPlayer == nullptr) continue;
+            if (myMap != tPlayer->FindMap()) continue;
+            if (tPlayer->HaveBot())
+                addBots(tPlayer->GetBotMgr()->GetBotMap());
+            addControlled(tPlayer);
+            if (!tPlayer->IsAlive() || tPlayer->HasUnitState(UNIT_STATE_ISOLATED)) continue;
+            if (GetHealthPCT(tPlayer) < 95 || IsTank(tPlayer))
+                queue.AddCandidate(tPlayer, GetOwnerDPSTaken(tPlayer));
+            addVehicle(tPlayer->GetVehicleBase());
+        }
+
+        //check if we have pointed heal target
+        for (uint8 i = 0; i != TARGETICONCOUNT; ++i)
+        {
+            if (BotMgr::GetHealTargetIconFlags() & GroupIconsFlags[i])
+            {
+                if (ObjectGuid guid = pGroup->GetTargetIcons()[i])
+                {
+                    if (Unit* unit = ObjectAccessor::GetUnit(*me, guid))
+                    {
+                        if (unit->IsAlive() && !unit->HasUnitState(UNIT_STATE_ISOLATED) && myMap == unit->FindMap() &&
+                            !unit->IsFullHealth() && unit->GetEntry() != SHAMAN_EARTH_ELEMENTAL &&
+                            !(unit->GetTypeId() == TYPEID_UNIT && unit->ToCreature()->GetCreatureTemplate()->type == CREATURE_TYPE_MECHANICAL))
+                        {
+                            queue.AddCandidate(unit, GetOwnerDPSTaken(unit), true);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    queue.Build();
+}
 // Buffs And Heal (really)
 // Priority as follows: 1) heal players 2) buff players 3) heal bots 4) buff bots
 // Priority adjustments to be considered
@@ -1387,54 +1499,30 @@ void bot_ai::BuffAndHealGroup(uint32 diff)
         return;
     }
 
-    BotMap const* map;
+    //heals
     Group const* pGroup = master->GetGroup();
-    if (!pGroup)
+    if (HasRole(BOT_ROLE_HEAL))
     {
-        //heals
-        map = master->GetBotMgr()->GetBotMap();
-        if (HasRole(BOT_ROLE_HEAL))
-        {
-            std::list<Unit*> targets3;
-            if (master->IsAlive() && !master->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(master) < 95 && me->GetDistance(master) < 40)
-                targets3.push_back(master);
-            if (master->GetVehicleBase() && !(master->GetVehicleBase()->GetTypeId() == TYPEID_UNIT &&
-                master->GetVehicleCreatureBase()->GetCreatureTemplate()->type == CREATURE_TYPE_MECHANICAL) &&
-                !master->GetVehicleBase()->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(master->GetVehicleBase()) < 95 &&
-                me->GetDistance(master->GetVehicleBase()) < 40)
-                targets3.push_back(master->GetVehicleBase());
-            for (BotMap::const_iterator itr = map->begin(); itr != map->end(); ++itr)
-            {
-                Unit* u = itr->second;
-                if (!(!u->IsInWorld() || me->GetMap() != u->FindMap() || !u->IsAlive() || u->HasUnitState(UNIT_STATE_ISOLATED) ||
-                    u->ToCreature()->IsTempBot() || me->GetDistance(u) > 40 ||
-                    (GetHealthPCT(u) > 95 && !IsTank(u))))
-                    targets3.push_back(u);
-
-                u = itr->second->GetBotsPet();
-
-                if (!(!u || !u->IsAlive() || u->HasUnitState(UNIT_STATE_ISOLATED) || me->GetDistance(u) > 40 || GetHealthPCT(u) > 95))
-                    targets3.push_back(u);
-
-                u = itr->second->GetVehicleBase();
-                if (u && !(u->GetTypeId() == TYPEID_UNIT && u->ToCreature()->GetCreatureTemplate()->type == CREATURE_TYPE_MECHANICAL) &&
-                    !u->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(u) < 95 && me->GetDistance(u) < 40)
-                    targets3.push_back(u);
-            }
-            for (Unit::ControlSet::const_iterator itr = master->m_Controlled.begin(); itr != master->m_Controlled.end(); ++itr)
-            {
-                Unit* u = *itr;
-                if (!u->IsInWorld() || me->GetMap() != u->FindMap() || !u->IsAlive() || u->HasUnitState(UNIT_STATE_ISOLATED) ||
-                    u->IsTotem() || u->GetEntry() == SHAMAN_EARTH_ELEMENTAL || me->GetDistance(u) > 40 ||
-                    (GetHealthPCT(u) > 95 && !IsTank(u)))
-                    continue;
+        BotHealQueue& queue = BotHealTriage::GetQueue(me->GetMap(), pGroup ? pGroup->GetGUID().GetRawValue() : master->GetGUID().GetRawValue());
+        if (!queue.IsBuilt())
+            _FillHealQueue(queue, pGroup);
 
-                targets3.push_back(u);
-            }
+        if (queue.Claim([this](BotHealQueue::Candidate const& candidate) {
+                Unit const* u = candidate.unit;
+                if (me->GetDistance(u) >= 40)
+                    return false;
+                //pointed target must not be fought by our party
+                return !candidate.pointed ||
+                    (master->GetVictim() != u && !IsInBotParty(u->GetVictim()) && u->GetReactionTo(master) >= REP_NEUTRAL);
+            },
+            [this, diff](Unit* u) { return HealTarget(u, diff); }, BOT_HEAL_TRIAGE_MAX_ATTEMPTS))
+            return;
+    }
 
-            if (!targets3.empty() && HealTarget(Acore::Containers::SelectRandomContainerElement(targets3), diff))
-                return;
-        }
+    BotMap const* map;
+    if (!pGroup)
+    {
+        map = master->GetBotMgr()->GetBotMap();
         //buffs
         std::list<Unit*> targets4;
         if (master->IsAlive() && me->GetDistance(master) < 30)
@@ -1466,94 +1554,6 @@ void bot_ai::BuffAndHealGroup(uint32 diff)
         return;
     }
     bool Bots = false;
-    //heals
-    if (HasRole(BOT_ROLE_HEAL))
-    {
-        std::list<Unit*> targets5;
-        for (GroupReference const* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
-        {
-            Player* tPlayer = itr->GetSource();
-            if (tPlayer == nullptr) continue;
-            if (me->GetMap() != tPlayer->FindMap()) continue;
-            if (tPlayer->HaveBot() && !Bots)
-                Bots = true;
-            if (!tPlayer->IsAlive() || tPlayer->HasUnitState(UNIT_STATE_ISOLATED)) continue;
-            if (me->GetDistance(tPlayer) > 40) continue;
-            if (GetHealthPCT(tPlayer) < 95 || IsTank(tPlayer))
-                targets5.push_back(tPlayer);
-            if (tPlayer->GetVehicleBase() && !(tPlayer->GetVehicleBase()->GetTypeId() == TYPEID_UNIT &&
-                tPlayer->GetVehicleCreatureBase()->GetCreatureTemplate()->type == CREATURE_TYPE_MECHANICAL) &&
-                !tPlayer->GetVehicleBase()->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(tPlayer->GetVehicleBase()) < 95 &&
-                me->GetDistance(tPlayer->GetVehicleBase()) < 40)
-                targets5.push_back(tPlayer->GetVehicleBase());
-        }
-        if (Bots)
-        {
-            for (GroupReference const* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
-            {
-                Player const* tPlayer = itr->GetSource();
-                if (tPlayer == nullptr) continue;
-                if (me->GetMap() != tPlayer->FindMap()) continue;
-
-                if (tPlayer->HaveBot())
-                {
-                    map = tPlayer->GetBotMgr()->GetBotMap();
-                    for (BotMap::const_iterator bitr = map->begin(); bitr != map->end(); ++bitr)
-                    {
-                        Unit* u = bitr->second;
-                        if (!(!u->IsInWorld() || me->GetMap() != u->FindMap() || !u->IsAlive() || u->HasUnitState(UNIT_STATE_ISOLATED) ||
-                            u->ToCreature()->IsTempBot() || me->GetDistance(u) > 40 ||
-                            (GetHealthPCT(u) > 95 && !IsTank(u))))
-                            targets5.push_back(u);
-
-                        u = bitr->second->GetBotsPet();
-
-                        if (!(!u || !u->IsAlive() || u->HasUnitState(UNIT_STATE_ISOLATED) || me->GetDistance(u) > 40 || GetHealthPCT(u) > 95))
-                            targets5.push_back(u);
-
-                        u = bitr->second->GetVehicleBase();
-                        if (u && !(u->GetTypeId() == TYPEID_UNIT && u->ToCreature()->GetCreatureTemplate()->type == CREATURE_TYPE_MECHANICAL) &&
-                            !u->HasUnitState(UNIT_STATE_ISOLATED) && GetHealthPCT(u) < 95 && me->GetDistance(u) < 40)
-                            targets5.push_back(u);
-                    }
-                }
-                for (Unit::ControlSet::const_iterator bitr = master->m_Controlled.begin(); bitr != master->m_Controlled.end(); ++bitr)
-                {
-                    Unit* u = *bitr;
-                    if (!u || !u->IsInWorld() || me->GetMap() != u->FindMap() || !u->IsAlive() || u->HasUnitState(UNIT_STATE_ISOLATED) ||
-                        u->IsTotem() || u->GetEntry() == SHAMAN_EARTH_ELEMENTAL || me->GetDistance(u) > 40 ||
-                        (GetHealthPCT(u) > 95 && !IsTank(u)))
-                        continue;
-
-                    targets5.push_back(u);
-                }
-            }
-        }
-
-        //check if we have pointed heal target
-        for (uint8 i = 0; i != TARGETICONCOUNT; ++i)
-        {
-            if (BotMgr::GetHealTargetIconFlags() & GroupIconsFlags[i])
-            {
-                if (ObjectGuid guid = pGroup->GetTargetIcons()[i])
-                {
-                    if (Unit* unit = ObjectAccessor::GetUnit(*me, guid))
-                    {
-                        if (unit->IsAlive() && !unit->HasUnitState(UNIT_STATE_ISOLATED) && me->GetMap() == unit->FindMap() && me->GetDistance(unit) < 40 &&
-                            !unit->IsFullHealth() && master->GetVictim() != unit && !IsInBotParty(unit->GetVictim()) &&
-                            unit->GetEntry() != SHAMAN_EARTH_ELEMENTAL &&
-                            !(unit->GetTypeId() == TYPEID_UNIT && unit->ToCreature()->GetCreatureTemplate()->type == CREATURE_TYPE_MECHANICAL) &&
-                            unit->GetReactionTo(master) >= REP_NEUTRAL)
-                        {
-                            targets5.push_back(unit);
-                        }
-                    }
-                }
-            }
-        }
-        if (!targets5.empty() && HealTarget(Acore::Containers::SelectRandomContainerElement(targets5), diff))
-            return;
-    }
     //buffs
     std::list<Unit*> targets6;
     for (GroupReference const* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
@@ -2283,6 +2283,7 @@ void bot_ai::SetStats(bool force)
         return;
 
     shouldUpdateStats = false;
+    shouldUpdateRatings = false;
 
     uint8 myclass = _botclass;
     if (myclass == BOT_CLASS_DRUID && GetBotStance() != BOT_STANCE_NONE)
@@ -2754,6 +2755,166 @@ void bot_ai::SetStats(bool force)
     dmg_taken_phy = value;
     dmg_taken_mag = tempval;
 
+    //HEALTH
+    _OnHealthUpdate();
+
+    //RESILIENCE, HASTE, HIT, ARMOR PENETRATION, EXPERTISE, CRIT, DEFENSE, PARRY, DODGE, BLOCK
+    _SetRatingStats(mylevel, myclass);
+
+    //MANA
+    _OnManaUpdate();
+
+    if (IsCastingClass(_botclass))
+    {
+        //SPELL PENETRATION
+        value = IAmFree() ? mylevel : 0; // 80/0 at 80
+        //~1 SPPR = 1 spell penetration
+        value += _getTotalBotStat(BOT_STAT_MOD_SPELL_PENETRATION);
+        spellpen = uint32(value);
+
+        //SPELL POWER
+        value = /*IAmFree() ? std::max<int32>((int8(mylevel) - 30) * 40, 0) : */0; // +2000/+0 spp at 80
+        value += _getTotalBotStat(BOT_STAT_MOD_SPELL_POWER);
+
+        //class-specified mods
+        if (_botclass == BOT_CLASS_PALADIN && mylevel >= 50)
+        {
+            //Touched by the Light - 60% of strength to spell power
+            if (GetSpec() == BOT_SPEC_PALADIN_PROTECTION)
+                value += 0.6f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
+            //Sheath of Light - 30% attack power to spell power
+            if (GetSpec() == BOT_SPEC_PALADIN_RETRIBUTION)
+                value += 0.3f * me->GetTotalAttackPowerValue(BASE_ATTACK);
+            //Holy Guidance - 20% Intellect to spell power
+            if (GetSpec() == BOT_SPEC_PALADIN_HOLY)
+                value += 0.2f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+        }
+        if (_botclass == BOT_CLASS_PRIEST && mylevel >= 30)
+        {
+            float totalSpi = _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
+            //Spiritual Guidance - 25% Spirit to spell power
+            if (GetSpec() == BOT_SPEC_PRIEST_HOLY)
+                value += 0.25f * totalSpi;
+            //Twisted Faith - 20% Spirit to spell power
+            else if (mylevel >= 55 && GetSpec() == BOT_SPEC_PRIEST_SHADOW)
+                value += 0.2f * totalSpi;
+            //Shadowy Insight (Glyph of Shadow)
+            if (mylevel >= 30 &&
+                me->GetAuraEffect(SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT, SPELLFAMILY_GENERIC, 1499, 0))
+                value += 0.3f * totalSpi;
+        }
+        if (_botclass == BOT_CLASS_SHAMAN && mylevel >= 50 && GetSpec() == BOT_SPEC_SHAMAN_ENHANCEMENT)
+        {
+            //Mental Quickness - 30% attack power to spell power (only enhancement)
+            value += 0.3f * me->GetTotalAttackPowerValue(BASE_ATTACK);
+        }
+        if (_botclass == BOT_CLASS_DRUID && mylevel >= 30)
+        {
+            //Nurturing Instinct - 70% Agility to spell power
+            value += 0.7f * _getTotalBotStat(BOT_STAT_MOD_AGILITY);
+            //Lunar Guidance - 12% Intellect to spell power
+            value += 0.12f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+            //Improved Moonkin Form - 30% Spirit to spell power
+            if (mylevel >= 40 && myclass == DRUID_MOONKIN_FORM)
+                value += 0.3f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
+            //Improved Tree (of Life) Form - 15% Spirit to spell power
+            if (mylevel >= 50 && myclass == DRUID_TREE_FORM)
+                value += 0.15f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
+        }
+        if (_botclass == BOT_CLASS_MAGE && mylevel >= 45 && GetSpec() == BOT_SPEC_MAGE_ARCANE)
+        {
+            //Mind Mastery - 15% Intellect to spell power
+            value += 0.15f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+        }
+        if (_botclass == BOT_CLASS_WARLOCK)
+        {
+            if (me->GetAuraEffect(SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT, SPELLFAMILY_WARLOCK, 0x0, 0x20000000, 0x0))
+            {
+                //Fel Armor + Demonic Aegis - 39% Spirit to spell power
+                value += 0.39f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
+            }
+            //Demonic Knowledge
+            if (botPet && botPet->IsAlive() && mylevel >= 40 && GetSpec() == BOT_SPEC_WARLOCK_DEMONOLOGY)
+                value += 0.12f * botPet->GetStat(STAT_STAMINA) + botPet->GetStat(STAT_INTELLECT);
+            //Glyph of Life Tap: 20% of spirit to spellpower
+            if (me->GetAuraEffect(SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT, SPELLFAMILY_WARLOCK, 208, 0))
+                value += 0.2f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
+        }
+        if (_botclass == BOT_CLASS_SPHYNX)
+        {
+            //bonus from attack power (for tank) or intellect (ranged)
+            value += 2.0f *_getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+            value += 0.5f * me->GetTotalAttackPowerValue(BASE_ATTACK);
+            //from wands
+            for (uint8 i = BOT_SLOT_MAINHAND; i <= BOT_SLOT_OFFHAND; ++i)
+                if (ItemTemplate const* proto = _equips[i] ? _equips[i]->GetTemplate() : nullptr)
+                    value += proto->getDPS() * 1.35f;
+        }
+        if (_botclass == BOT_CLASS_ARCHMAGE)
+        {
+            //bonus from intellect
+            value += _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+        }
+        if (_botclass == BOT_CLASS_DREADLORD)
+        {
+            //bonus from strength
+            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
+        }
+        if (_botclass == BOT_CLASS_SPELLBREAKER)
+        {
+            //bonus from strength
+            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
+        }
+        if (_botclass == BOT_CLASS_DARK_RANGER)
+        {
+            //bonus from intellect
+            value += 0.5f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+        }
+        if (_botclass == BOT_CLASS_NECROMANCER)
+        {
+            //bonus from intellect
+            value += _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+        }
+        if (_botclass == BOT_CLASS_SEA_WITCH)
+        {
+            //bonus from intellect
+            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+        }
+        if (_botclass == BOT_CLASS_CRYPT_LORD)
+        {
+            //bonus from strength
+            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
+        }
+
+        spellpower = uint32(value);
+    }
+    //else
+    //{
+    //    spellpower = 0;
+    //}
+
+    //if init or levelup
+    if (force)
+    {
+        InitHeals();
+        me->SetFullHealth();
+        if (_botclass != BOT_CLASS_SPHYNX)
+            me->SetPower(POWER_MANA, me->GetMaxPower(POWER_MANA));
+
+        me->ResetPlayerDamageReq();
+    }
+
+    if (botPet)
+        botPet->GetBotPetAI()->SetShouldUpdateStats();
+}
+
+//Rating based stats. Also read primary stats (agility, intellect, spirit, strength for crit, dodge, parry and block),
+//so SetStats() must keep calling this whenever stats change; only rating auras update it on its own
+void bot_ai::_SetRatingStats(uint8 mylevel, uint8 myclass)
+{
+    float value;
+    float tempval;
+
     //RESILIENCE
     value = 0.f;
 
@@ -2763,9 +2924,6 @@ void bot_ai::SetStats(bool force)
 
     resilience = value;
 
-    //HEALTH
-    _OnHealthUpdate();
-
     //HASTE
     if (haste)
     {
@@ -3165,240 +3323,111 @@ void bot_ai::SetStats(bool force)
 
         if (GtChanceToMeleeCritEntry  const* dodgeRatio = sGtChanceToMeleeCritStore.LookupEntry((GetPlayerClass()-1)*GT_MAX_LEVEL + mylevel-1))
             value += _getTotalBotStat(BOT_STAT_MOD_AGILITY) * dodgeRatio->ratio * 100.0f;
-
-        if (mylevel >= 10)
-        {
-            //53 DR = 1% dodge at 80
-            tempval = _getTotalBotStat(BOT_STAT_MOD_DODGE_RATING);
-            tempval += me->GetTotalAuraModifierByMiscMask(SPELL_AURA_MOD_RATING, (1 << CR_DODGE));
-            value += tempval * _getRatingMultiplier(CR_DODGE);
-            //125 DR = 1% block/parry/dodge at 80
-            value += defbonus * 0.04f;
-        }
-
-        //evasion, anticipation (general)
-        if ((_botclass == BOT_CLASS_WARRIOR || _botclass == BOT_CLASS_ROGUE || _botclass == BOT_CLASS_PALADIN ||
-            _botclass == BOT_CLASS_DEATH_KNIGHT || _botclass == BOT_CLASS_SHAMAN) && mylevel >= 15)
-            value += 5.0f;
-
-        //class-specific
-        if (_botclass == BOT_CLASS_DRUID)
-        {
-            //Feral Swiftness
-            if (mylevel >= 20 && (myclass == DRUID_CAT_FORM || myclass == DRUID_BEAR_FORM))
-                value += 4.f;
-        }
-
-        if (_botclass == BOT_CLASS_DARK_RANGER)
-        {
-            //base dodge 30%
-            value += 30.f;
-        }
-
-        if (_botclass == BOT_CLASS_SEA_WITCH && IsInContactWithWater())
-        {
-            //TC_LOG_ERROR("scripts", "BOT_CLASS_SEA_WITCH dodge: %s now in water", me->GetName().c_str());
-            value += 50.f;
-        }
-
-        if (BotMgr::IsBotStatsLimitsEnabled())
-            dodge = std::min<float>(value, BotMgr::GetBotStatLimitDodge());
-        else
-            dodge = value;
-
-        if (dodge < 0.0f)
-            dodge = 0.0f;
-    }
-    else
-        dodge = 0.0f;
-
-    //BLOCK
-    if (IsBlockingClass(_botclass))
-    {
-        value = 5.0f + (IAmFree() ? mylevel / 4 : 0); // +20%/+0% at 80
-
-        //16.5 BR = 1% block at 80
-        tempval = _getTotalBotStat(BOT_STAT_MOD_BLOCK_RATING);
-        tempval += me->GetTotalAuraModifierByMiscMask(SPELL_AURA_MOD_RATING, (1 << CR_BLOCK));
-        value += tempval * _getRatingMultiplier(CR_BLOCK);
-        //125 DR = 1% block/parry/dodge at 80
-        value += defbonus * 0.04f;
-
-        //base block chance is capped at 75%
-        if (BotMgr::IsBotStatsLimitsEnabled())
-            block = std::min<float>(value, BotMgr::GetBotStatLimitBlock());
-        else
-            block = std::min<float>(value, 75.0f);
-
-        if (block < 0.0f)
-            block = 0.0f;
-
-        //Spellbreaker wears tall shield so should always block
-        if (_botclass == BOT_CLASS_SPELLBREAKER)
-            block += 90.f;
-
-        //BLOCK VALUE
-        //2 str = 1 block value
-        value = 0.5f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH) - 10.f;
-        value += _getTotalBotStat(BOT_STAT_MOD_BLOCK_VALUE);
-
-        //Shield Mastery part 1
-        if (_botclass == BOT_CLASS_WARRIOR && mylevel >= 20 && GetSpec() == BOT_SPEC_WARRIOR_PROTECTION)
-            value *= 1.3f;
-        //Redoubt handled in passives
-        //if (mylevel >= 45 && _botclass == BOT_CLASS_PALADIN)
-        //    value *= 1.3f;
-
-        blockvalue = std::max<float>(int32(value), 1.f);
-    }
-    //else
-    //{
-    //    block = 0.0f;
-    //    blockvalue = 0;
-    //}
-
-    //MANA
-    _OnManaUpdate();
-
-    if (IsCastingClass(_botclass))
-    {
-        //SPELL PENETRATION
-        value = IAmFree() ? mylevel : 0; // 80/0 at 80
-        //~1 SPPR = 1 spell penetration
-        value += _getTotalBotStat(BOT_STAT_MOD_SPELL_PENETRATION);
-        spellpen = uint32(value);
-
-        //SPELL POWER
-        value = /*IAmFree() ? std::max<int32>((int8(mylevel) - 30) * 40, 0) : */0; // +2000/+0 spp at 80
-        value += _getTotalBotStat(BOT_STAT_MOD_SPELL_POWER);
-
-        //class-specified mods
-        if (_botclass == BOT_CLASS_PALADIN && mylevel >= 50)
-        {
-            //Touched by the Light - 60% of strength to spell power
-            if (GetSpec() == BOT_SPEC_PALADIN_PROTECTION)
-                value += 0.6f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
-            //Sheath of Light - 30% attack power to spell power
-            if (GetSpec() == BOT_SPEC_PALADIN_RETRIBUTION)
-                value += 0.3f * me->GetTotalAttackPowerValue(BASE_ATTACK);
-            //Holy Guidance - 20% Intellect to spell power
-            if (GetSpec() == BOT_SPEC_PALADIN_HOLY)
-                value += 0.2f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
-        }
-        if (_botclass == BOT_CLASS_PRIEST && mylevel >= 30)
-        {
-            float totalSpi = _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
-            //Spiritual Guidance - 25% Spirit to spell power
-            if (GetSpec() == BOT_SPEC_PRIEST_HOLY)
-                value += 0.25f * totalSpi;
-            //Twisted Faith - 20% Spirit to spell power
-            else if (mylevel >= 55 && GetSpec() == BOT_SPEC_PRIEST_SHADOW)
-                value += 0.2f * totalSpi;
-            //Shadowy Insight (Glyph of Shadow)
-            if (mylevel >= 30 &&
-                me->GetAuraEffect(SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT, SPELLFAMILY_GENERIC, 1499, 0))
-                value += 0.3f * totalSpi;
-        }
-        if (_botclass == BOT_CLASS_SHAMAN && mylevel >= 50 && GetSpec() == BOT_SPEC_SHAMAN_ENHANCEMENT)
-        {
-            //Mental Quickness - 30% attack power to spell power (only enhancement)
-            value += 0.3f * me->GetTotalAttackPowerValue(BASE_ATTACK);
-        }
-        if (_botclass == BOT_CLASS_DRUID && mylevel >= 30)
-        {
-            //Nurturing Instinct - 70% Agility to spell power
-            value += 0.7f * _getTotalBotStat(BOT_STAT_MOD_AGILITY);
-            //Lunar Guidance - 12% Intellect to spell power
-            value += 0.12f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
-            //Improved Moonkin Form - 30% Spirit to spell power
-            if (mylevel >= 40 && myclass == DRUID_MOONKIN_FORM)
-                value += 0.3f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
-            //Improved Tree (of Life) Form - 15% Spirit to spell power
-            if (mylevel >= 50 && myclass == DRUID_TREE_FORM)
-                value += 0.15f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
-        }
-        if (_botclass == BOT_CLASS_MAGE && mylevel >= 45 && GetSpec() == BOT_SPEC_MAGE_ARCANE)
-        {
-            //Mind Mastery - 15% Intellect to spell power
-            value += 0.15f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
-        }
-        if (_botclass == BOT_CLASS_WARLOCK)
-        {
-            if (me->GetAuraEffect(SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT, SPELLFAMILY_WARLOCK, 0x0, 0x20000000, 0x0))
-            {
-                //Fel Armor + Demonic Aegis - 39% Spirit to spell power
-                value += 0.39f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
-            }
-            //Demonic Knowledge
-            if (botPet && botPet->IsAlive() && mylevel >= 40 && GetSpec() == BOT_SPEC_WARLOCK_DEMONOLOGY)
-                value += 0.12f * botPet->GetStat(STAT_STAMINA) + botPet->GetStat(STAT_INTELLECT);
-            //Glyph of Life Tap: 20% of spirit to spellpower
-            if (me->GetAuraEffect(SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT, SPELLFAMILY_WARLOCK, 208, 0))
-                value += 0.2f * _getTotalBotStat(BOT_STAT_MOD_SPIRIT);
-        }
-        if (_botclass == BOT_CLASS_SPHYNX)
-        {
-            //bonus from attack power (for tank) or intellect (ranged)
-            value += 2.0f *_getTotalBotStat(BOT_STAT_MOD_INTELLECT);
-            value += 0.5f * me->GetTotalAttackPowerValue(BASE_ATTACK);
-            //from wands
-            for (uint8 i = BOT_SLOT_MAINHAND; i <= BOT_SLOT_OFFHAND; ++i)
-                if (ItemTemplate const* proto = _equips[i] ? _equips[i]->GetTemplate() : nullptr)
-                    value += proto->getDPS() * 1.35f;
-        }
-        if (_botclass == BOT_CLASS_ARCHMAGE)
-        {
-            //bonus from intellect
-            value += _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
-        }
-        if (_botclass == BOT_CLASS_DREADLORD)
-        {
-            //bonus from strength
-            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
-        }
-        if (_botclass == BOT_CLASS_SPELLBREAKER)
-        {
-            //bonus from strength
-            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
-        }
-        if (_botclass == BOT_CLASS_DARK_RANGER)
+
+        if (mylevel >= 10)
         {
-            //bonus from intellect
-            value += 0.5f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+            //53 DR = 1% dodge at 80
+            tempval = _getTotalBotStat(BOT_STAT_MOD_DODGE_RATING);
+            tempval += me->GetTotalAuraModifierByMiscMask(SPELL_AURA_MOD_RATING, (1 << CR_DODGE));
+            value += tempval * _getRatingMultiplier(CR_DODGE);
+            //125 DR = 1% block/parry/dodge at 80
+            value += defbonus * 0.04f;
         }
-        if (_botclass == BOT_CLASS_NECROMANCER)
+
+        //evasion, anticipation (general)
+        if ((_botclass == BOT_CLASS_WARRIOR || _botclass == BOT_CLASS_ROGUE || _botclass == BOT_CLASS_PALADIN ||
+            _botclass == BOT_CLASS_DEATH_KNIGHT || _botclass == BOT_CLASS_SHAMAN) && mylevel >= 15)
+            value += 5.0f;
+
+        //class-specific
+        if (_botclass == BOT_CLASS_DRUID)
         {
-            //bonus from intellect
-            value += _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+            //Feral Swiftness
+            if (mylevel >= 20 && (myclass == DRUID_CAT_FORM || myclass == DRUID_BEAR_FORM))
+                value += 4.f;
         }
-        if (_botclass == BOT_CLASS_SEA_WITCH)
+
+        if (_botclass == BOT_CLASS_DARK_RANGER)
         {
-            //bonus from intellect
-            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_INTELLECT);
+            //base dodge 30%
+            value += 30.f;
         }
-        if (_botclass == BOT_CLASS_CRYPT_LORD)
+
+        if (_botclass == BOT_CLASS_SEA_WITCH && IsInContactWithWater())
         {
-            //bonus from strength
-            value += 2.f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH);
+            //TC_LOG_ERROR("scripts", "BOT_CLASS_SEA_WITCH dodge: %s now in water", me->GetName().c_str());
+            value += 50.f;
         }
 
-        spellpower = uint32(value);
+        if (BotMgr::IsBotStatsLimitsEnabled())
+            dodge = std::min<float>(value, BotMgr::GetBotStatLimitDodge());
+        else
+            dodge = value;
+
+        if (dodge < 0.0f)
+            dodge = 0.0f;
+    }
+    else
+        dodge = 0.0f;
+
+    //BLOCK
+    if (IsBlockingClass(_botclass))
+    {
+        value = 5.0f + (IAmFree() ? mylevel / 4 : 0); // +20%/+0% at 80
+
+        //16.5 BR = 1% block at 80
+        tempval = _getTotalBotStat(BOT_STAT_MOD_BLOCK_RATING);
+        tempval += me->GetTotalAuraModifierByMiscMask(SPELL_AURA_MOD_RATING, (1 << CR_BLOCK));
+        value += tempval * _getRatingMultiplier(CR_BLOCK);
+        //125 DR = 1% block/parry/dodge at 80
+        value += defbonus * 0.04f;
+
+        //base block chance is capped at 75%
+        if (BotMgr::IsBotStatsLimitsEnabled())
+            block = std::min<float>(value, BotMgr::GetBotStatLimitBlock());
+        else
+            block = std::min<float>(value, 75.0f);
+
+        if (block < 0.0f)
+            block = 0.0f;
+
+        //Spellbreaker wears tall shield so should always block
+        if (_botclass == BOT_CLASS_SPELLBREAKER)
+            block += 90.f;
+
+        //BLOCK VALUE
+        //2 str = 1 block value
+        value = 0.5f * _getTotalBotStat(BOT_STAT_MOD_STRENGTH) - 10.f;
+        value += _getTotalBotStat(BOT_STAT_MOD_BLOCK_VALUE);
+
+        //Shield Mastery part 1
+        if (_botclass == BOT_CLASS_WARRIOR && mylevel >= 20 && GetSpec() == BOT_SPEC_WARRIOR_PROTECTION)
+            value *= 1.3f;
+        //Redoubt handled in passives
+        //if (mylevel >= 45 && _botclass == BOT_CLASS_PALADIN)
+        //    value *= 1.3f;
+
+        blockvalue = std::max<float>(int32(value), 1.f);
     }
     //else
     //{
-    //    spellpower = 0;
+    //    block = 0.0f;
+    //    blockvalue = 0;
     //}
+}
 
-    //if init or levelup
-    if (force)
-    {
-        InitHeals();
-        me->SetFullHealth();
-        if (_botclass != BOT_CLASS_SPHYNX)
-            me->SetPower(POWER_MANA, me->GetMaxPower(POWER_MANA));
+void bot_ai::UpdateRatingStats()
+{
+    if (IsTempBot())
+        return;
 
-        me->ResetPlayerDamageReq();
-    }
+    shouldUpdateRatings = false;
+
+    uint8 myclass = _botclass;
+    if (myclass == BOT_CLASS_DRUID && GetBotStance() != BOT_STANCE_NONE)
+        myclass = GetBotStance();
+
+    _SetRatingStats(me->GetLevel(), myclass);
 
     if (botPet)
         botPet->GetBotPetAI()->SetShouldUpdateStats();
@@ -4914,39 +4943,32 @@ AoeSpotsVec const& bot_ai::GetAoeSpots() const
 
 void bot_ai::CalculateAoeSpots(Unit const* unit, AoeSpotsVec& spots)
 {
-    std::list<WorldObject*> doList;
-    NearbyHostileAoEDynobjectCheck check(unit, 60.f);
-    Acore::WorldObjectListSearcher<NearbyHostileAoEDynobjectCheck> searcher(unit, doList, check, GRID_MAP_TYPE_MASK_DYNAMICOBJECT);
-    //unit->VisitNearbyObject(60.f, searcher);
-    Cell::VisitAllObjects(unit, searcher, 60.f);
+    std::vector<DynamicObject*> doList;
+    BotAoeZoneRegistry::GetZonesInRange(unit, 60.f, doList);
 
     //if (!doList.empty())
     //    TC_LOG_ERROR("scripts", "CalculateAoeSpots %u aoes around %s", uint32(doList.size()), unit->GetName().c_str());
 
-    //filter and add to list
-    DynamicObject const* dObj;
-    SpellInfo const* spellInfo;
-    for (std::list<WorldObject*>::const_iterator ci = doList.begin(); ci != doList.end(); ++ci)
+    //filter and add to list, spell type is already checked by registry
+    NearbyHostileAoEDynobjectCheck check(unit, 60.f);
+    for (DynamicObject const* dObj : doList)
     {
-        dObj = (*ci)->ToDynObject();
-        ASSERT_NODEBUGINFO(dObj);
-        ASSERT_NODEBUGINFO(dObj->GetSpellId());
-        spellInfo = sSpellMgr->GetSpellInfo(dObj->GetSpellId());
-        if (IsPeriodicDynObjAOEDamage(spellInfo))
-        {
-            //TC_LOG_ERROR("scripts", "CalculateAoeSpots found %s's aoe %s (%u) radius %.2f size %.2f",
-            //    dObj->GetCaster()->GetName().c_str(), spellInfo->SpellName[0], spellInfo->Id, dObj->GetRadius(), dObj->GetObjectSize());
+        if (!check(dObj))
+            continue;
 
-            float radius = dObj->GetRadius() + DEFAULT_WORLD_OBJECT_SIZE;
-            radius += (unit->GetVehicle() ? unit->GetVehicleBase()->GetCombatReach() : DEFAULT_COMBAT_REACH) * 1.2f;
-            spots.push_back(AoeSpotsVec::value_type(*dObj, radius));
-        }
+        //TC_LOG_ERROR("scripts", "CalculateAoeSpots found %s's aoe %s (%u) radius %.2f size %.2f",
+        //    dObj->GetCaster()->GetName().c_str(), spellInfo->SpellName[0], spellInfo->Id, dObj->GetRadius(), dObj->GetObjectSize());
+
+        float radius = dObj->GetRadius() + DEFAULT_WORLD_OBJECT_SIZE;
+        radius += (unit->GetVehicle() ? unit->GetVehicleBase()->GetCombatReach() : DEFAULT_COMBAT_REACH) * 1.2f;
+        spots.push_back(AoeSpotsVec::value_type(*dObj, radius));
     }
 
     if (unit->IsNPCBot() && unit->ToCreature()->IsFreeBot())
         return;
 
     //Additional: aoe coming from spawned npcs
+    SpellInfo const* spellInfo;
 
     //The Eye of Eternity
     if (unit->GetMapId() == 616 && unit->GetVehicle())
@@ -6178,14 +6200,12 @@ Unit* bot_ai::FindImmunityShieldDispelTarget(float dist) const
     if (me->GetVictim() && me->GetVictim()->HasAuraWithMechanic(1<<MECHANIC_IMMUNE_SHIELD))
         return me->GetVictim();
 
-    Unit* unit = nullptr;
-
     ImmunityShieldDispelTargetCheck check(me, dist, this);
-    Acore::UnitSearcher <ImmunityShieldDispelTargetCheck> searcher(me, unit, check);
-    Cell::VisitAllObjects(me, searcher, dist);
-    //me->VisitNearbyObject(dist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, dist))
+        if (check(unit))
+            return unit;
 
-    return unit;
+    return nullptr;
 }
 //Used to find target for priest's dispels, mage's spellsteal and shaman's purge
 //Returns dispellable/stealable 'Any Hostile Unit Attacking BotParty'
@@ -6194,9 +6214,9 @@ Unit* bot_ai::FindHostileDispelTarget(float dist, bool stealable) const
     std::list<Unit*> unitList;
 
     HostileDispelTargetCheck check(me, dist, stealable, this);
-    Acore::UnitListSearcher <HostileDispelTargetCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
-    //me->VisitNearbyObject(dist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, dist))
+        if (check(unit))
+            unitList.push_back(unit);
 
     if (unitList.empty())
         return nullptr;
@@ -6228,21 +6248,69 @@ Unit* bot_ai::FindAffectedTarget(uint32 spellId, ObjectGuid caster, float dist,
     Unit* unit = nullptr;
 
     AffectedTargetCheck check(caster, dist, spellId, master, hostile);
+
+    //own auras: look up indexed targets instead of searching grid
+    if (caster == me->GetGUID())
+    {
+        AuraTargetsMap::const_iterator itr = _auraTargets.find(spellId);
+        if (itr == _auraTargets.end())
+            return nullptr;
+
+        for (ObjectGuid const& guid : itr->second)
+        {
+            unit = ObjectAccessor::GetUnit(*me, guid);
+            if (unit && unit->IsInWorld() && master->InSamePhase(unit) && check(unit))
+                return unit;
+        }
+
+        return nullptr;
+    }
+
     Acore::UnitSearcher <AffectedTargetCheck> searcher(master, unit, check);
     Cell::VisitAllObjects(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     return unit;
 }
+//Index of auras applied by bot, maintained by Unit aura application code
+void bot_ai::OnBotAuraApplied(Unit const* target, uint32 spellId)
+{
+    std::vector<ObjectGuid>& targets = _auraTargets[spellId];
+
+    //removal is missed if aura outlives bot's presence on target's map, drop stale entries
+    if (targets.size() >= 8)
+    {
+        targets.erase(std::remove_if(targets.begin(), targets.end(), [this, spellId](ObjectGuid const& guid) {
+            Unit const* unit = ObjectAccessor::GetUnit(*me, guid);
+            return !unit || !unit->HasAura(spellId, me->GetGUID());
+        }), targets.end());
+    }
+
+    targets.push_back(target->GetGUID());
+}
+void bot_ai::OnBotAuraRemoved(Unit const* target, uint32 spellId)
+{
+    AuraTargetsMap::iterator itr = _auraTargets.find(spellId);
+    if (itr == _auraTargets.end())
+        return;
+
+    std::vector<ObjectGuid>& targets = itr->second;
+    std::vector<ObjectGuid>::iterator titr = std::find(targets.begin(), targets.end(), target->GetGUID());
+    if (titr != targets.end())
+    {
+        *titr = targets.back();
+        targets.pop_back();
+    }
+}
 //Finds target for mage's polymorph or shaman's hex
 Unit* bot_ai::FindPolyTarget(float dist) const
 {
     std::list<Unit*> unitList;
 
     PolyUnitCheck check(me, dist);
-    Acore::UnitListSearcher <PolyUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
-    //me->VisitNearbyObject(dist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, dist))
+        if (check(unit))
+            unitList.push_back(unit);
 
     if (unitList.empty())
         return nullptr;
@@ -6257,9 +6325,9 @@ Unit* bot_ai::FindFearTarget(float dist) const
     std::list<Unit*> unitList;
 
     FearUnitCheck check(me, dist);
-    Acore::UnitListSearcher <FearUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
-    //me->VisitNearbyObject(dist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, dist))
+        if (check(unit))
+            unitList.push_back(unit);
 
     if (unitList.empty())
         return nullptr;
@@ -6274,9 +6342,9 @@ Unit* bot_ai::FindStunTarget(float dist) const
     std::list<Unit*> unitList;
 
     StunUnitCheck check(me, dist);
-    Acore::UnitListSearcher <StunUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
-    //me->VisitNearbyObject(dist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, dist))
+        if (check(unit))
+            unitList.push_back(unit);
 
     if (unitList.empty())
         return nullptr;
@@ -6294,9 +6362,9 @@ Unit* bot_ai::FindUndeadCCTarget(float dist, uint32 spellId, bool unattacked) co
     std::list<Unit*> unitList;
 
     UndeadCCUnitCheck check(me, dist, this, spellId, unattacked);
-    Acore::UnitListSearcher <UndeadCCUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
-    //me->VisitNearbyObject(dist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, dist))
+        if (check(unit))
+            unitList.push_back(unit);
 
     if (unitList.empty())
         return nullptr;
@@ -6314,9 +6382,9 @@ Unit* bot_ai::FindRootTarget(float dist, uint32 spellId) const
     std::list<Unit*> unitList;
 
     RootUnitCheck check(me, dist, this, spellId);
-    Acore::UnitListSearcher <RootUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
-    //me->VisitNearbyObject(dist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, dist))
+        if (check(unit))
+            unitList.push_back(unit);
 
     if (unitList.empty())
         return nullptr;
@@ -6332,9 +6400,9 @@ Unit* bot_ai::FindCastingTarget(float maxdist, float mindist, uint32 spellId, ui
     std::list<Unit*> unitList;
 
     CastingUnitCheck check(me, mindist, maxdist, spellId, minHpPct);
-    Acore::UnitListSearcher <CastingUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
-    //me->VisitNearbyObject(maxdist, searcher);
+    for (Unit* unit : GetHostileScanBucket(BOT_HOSTILE_SCAN_CASTING, maxdist))
+        if (check(unit))
+            unitList.push_back(unit);
 
     if (unitList.empty())
         return nullptr;
@@ -6487,6 +6555,50 @@ Unit* bot_ai::FindDrainTarget(float maxdist) const
 
     return unit;
 }
+//Decide phase of BotDecisionPipeline, only fills per tick caches that UpdateAI is about to use
+//Must not modify anything except bot's own mutable caches
+void bot_ai::PrepareUpdate(uint32 diff) const
+{
+    if (waitTimer > diff * 2 || !me->IsInWorld() || !me->IsAlive() || !master->IsInWorld())
+        return;
+
+    //only for bots which are actually using hostile scan
+    uint32 tick = uint32(GameTime::GetGameTimeMS().count());
+    if (_hostileScanRange > 0.f && tick - _hostileScanTick < BOT_DECISION_SCAN_KEEP_TIME)
+        GetHostileScanBucket(BOT_HOSTILE_SCAN_ENGAGED, _hostileScanRange);
+}
+//Classifies units around bot once per tick into buckets used by Find*Target() functions
+//Only parameter-independent conditions shared by bucket's checks are applied here
+std::vector<Unit*> const& bot_ai::GetHostileScanBucket(BotHostileScanBuckets bucket, float dist) const
+{
+    uint32 tick = uint32(GameTime::GetGameTimeMS().count());
+    if (_hostileScanTick != tick || _hostileScanRange < dist)
+    {
+        _hostileScanTick = tick;
+        _hostileScanRange = dist;
+        for (uint8 i = 0; i != MAX_BOT_HOSTILE_SCAN_BUCKETS; ++i)
+            _hostileScan[i].clear();
+
+        std::vector<Unit*> units;
+        BotGridCache::GetUnitsInRange(me, _hostileScanRange, units);
+
+        bool checkPvP = !_botPvP && me->IsPvP();
+        for (Unit* unit : units)
+        {
+            if (checkPvP && unit->IsControlledByPlayer())
+                continue;
+
+            if (unit->IsInCombat())
+                _hostileScan[BOT_HOSTILE_SCAN_ENGAGED].push_back(unit);
+
+            if (unit->IsAlive() && (unit->GetTarget() || unit->IsInCombat()) && unit->IsVisible() && !unit->IsTotem() &&
+                unit->IsNonMeleeSpellCast(false, false, true) && unit->isTargetableForAttack(false) && unit->GetReactionTo(me) < REP_FRIENDLY)
+                _hostileScan[BOT_HOSTILE_SCAN_CASTING].push_back(unit);
+        }
+    }
+
+    return _hostileScan[bucket];
+}
 //Finds all targets within given range
 //used for finding targets for spells which need reasonable amount of targets (ex. Death Knight AOE spells)
 //CCoption:= mask
@@ -6497,29 +6609,38 @@ void bot_ai::GetNearbyTargetsList(std::list<Unit*> &targets, float maxdist, uint
     if (!source)
         source = me;
 
+    std::vector<Unit*> units;
+    BotGridCache::GetUnitsInRange(me, maxdist, units);
+
     NearbyHostileUnitCheck check(me, maxdist, this, CCoption, source);
-    Acore::UnitListSearcher <NearbyHostileUnitCheck> searcher(me, targets, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
-    //me->VisitNearbyObject(maxdist, searcher);
+    for (Unit* unit : units)
+        if (check(unit))
+            targets.push_back(unit);
 }
 //Find all targets within given range in cone in front of caster; angle is PI/2 (TC confirmed)
 //used by mage Dragon's Breath and Cone of Cold spells
 //also Swipe (Bear) and Swipe (Cat)
 void bot_ai::GetNearbyTargetsInConeList(std::list<Unit*> &targets, float maxdist) const
 {
+    std::vector<Unit*> units;
+    BotGridCache::GetUnitsInRange(me, maxdist, units);
+
     NearbyHostileUnitInConeCheck check(me, maxdist, this);
-    Acore::UnitListSearcher <NearbyHostileUnitInConeCheck> searcher(me, targets, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
-    //me->VisitNearbyObject(maxdist, searcher);
+    for (Unit* unit : units)
+        if (check(unit))
+            targets.push_back(unit);
 }
 //Finds all friendly targets within given range
 //used for finding targets to heal/buff for uncontrolled bots
 void bot_ai::GetNearbyFriendlyTargetsList(std::list<Unit*> &targets, float maxdist) const
 {
+    std::vector<Unit*> units;
+    BotGridCache::GetUnitsInRange(me, maxdist, units);
+
     NearbyFriendlyUnitCheck check(me, maxdist, this);
-    Acore::UnitListSearcher <NearbyFriendlyUnitCheck> searcher(me, targets, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
-    //me->VisitNearbyObject(maxdist, searcher);
+    for (Unit* unit : units)
+        if (check(unit))
+            targets.push_back(unit);
 }
 //////////
 //SPELLMAP
@@ -6569,19 +6690,13 @@ void bot_ai::InitSpellMap(uint32 basespell, bool forceadd, bool forwardRank)
         info = info->GetNextRankSpell(); //check next rank
     }
 
-    BotSpell* newSpell = _spells[basespell];
-    if (!newSpell)
-    {
-        newSpell = new BotSpell();
-        _spells[basespell] = newSpell;
-    }
-
-    newSpell->spellId = spellId;
+    BotSpell& newSpell = _AddSpell(basespell);
+    newSpell.spellId = spellId;
 
     NpcBotData const* npcBotData = BotDataMgr::SelectNpcBotData(me->GetEntry());
     if (npcBotData && npcBotData->disabled_spells.find(basespell) != npcBotData->disabled_spells.end())
     {
-        newSpell->enabled = false;
+        newSpell.enabled = false;
         //TC_LOG_ERROR("entities.player", "bot_ai::InitSpellMap(): %s (%u -> %u) is disabled for %s!",
         //    sSpellMgr->GetSpellInfo(basespell)->SpellName[0], basespell, spellId, me->GetName().c_str());
     }
@@ -6589,8 +6704,8 @@ void bot_ai::InitSpellMap(uint32 basespell, bool forceadd, bool forwardRank)
 //Using first-rank spell as source, return true if spell is inited
 bool bot_ai::HasSpell(uint32 basespell) const
 {
-    BotSpellMap::const_iterator itr = _spells.find(basespell);
-    return itr != _spells.end() && (itr->second->spellId != 0);
+    BotSpell const* spell = _FindSpell(basespell);
+    return spell && spell->spellId != 0;
 }
 //Using spell name as source, return first-rank spell if spell is inited
 uint32 bot_ai::GetBaseSpell(std::string_view spell_name, LocaleConstant locale) const
@@ -6600,19 +6715,19 @@ uint32 bot_ai::GetBaseSpell(std::string_view spell_name, LocaleConstant locale)
     if (Utf8toWStr(spell_name, wname))
     {
         wstrToLower(wname);
-        for (BotSpellMap::const_iterator itr = _spells.begin(); itr != _spells.end(); ++itr)
+        for (BotSpell const& spell : _spells)
         {
             //we ignore enabled state since this is exactly what we want
-            if (itr->second->spellId == 0) //not init'ed
+            if (spell.spellId == 0) //not init'ed
                 continue;
-            spell_name = sSpellMgr->GetSpellInfo(itr->first)->SpellName[locale];
+            spell_name = sSpellMgr->GetSpellInfo(spell.baseId)->SpellName[locale];
             std::wstring wcname;
             if (!Utf8toWStr(spell_name, wcname))
                 continue;
             wstrToLower(wcname);
             if (wcname == wname)
             {
-                basespell = itr->first;
+                basespell = spell.baseId;
                 break;
             }
         }
@@ -6623,24 +6738,24 @@ uint32 bot_ai::GetBaseSpell(std::string_view spell_name, LocaleConstant locale)
 //Using first-rank spell as source, return current spell id if inited and enabled
 uint32 bot_ai::GetSpell(uint32 basespell) const
 {
-    BotSpellMap::const_iterator itr = _spells.find(basespell);
-    return itr != _spells.end() && (itr->second->enabled == true || IAmFree()) ? itr->second->spellId : 0;
+    BotSpell const* spell = _FindSpell(basespell);
+    return spell && (spell->enabled == true || IAmFree()) ? spell->spellId : 0;
 }
 //Using first-rank spell as source, returns cooldown on current spell
 uint32 bot_ai::GetSpellCooldown(uint32 basespell) const
 {
-    BotSpellMap::const_iterator itr = _spells.find(basespell);
-    return itr != _spells.end() ? itr->second->cooldown : 0;
+    BotSpell const* spell = _FindSpell(basespell);
+    return spell ? _GetRemainingCooldown(*spell) : 0;
 }
 bool bot_ai::IsSpellReady(uint32 basespell, uint32 diff, bool checkGCD) const
 {
     if (checkGCD && GC_Timer > diff)
         return false;
 
-    BotSpellMap::const_iterator itr = _spells.find(basespell);
-    return itr == _spells.end() ? true :
-        ((itr->second->enabled == true || IAmFree() || IsLastOrder(BOT_ORDER_SPELLCAST, basespell)) &&
-            itr->second->spellId != 0 && itr->second->cooldown <= diff);
+    BotSpell const* spell = _FindSpell(basespell);
+    return !spell ? true :
+        ((spell->enabled == true || IAmFree() || IsLastOrder(BOT_ORDER_SPELLCAST, basespell)) &&
+            spell->spellId != 0 && spell->cooldownEnd <= _spellTimeMs + diff);
 }
 //Using first-rank spell as source, sets cooldown for current spell
 void bot_ai::SetSpellCooldown(uint32 basespell, uint32 msCooldown)
@@ -6648,10 +6763,9 @@ void bot_ai::SetSpellCooldown(uint32 basespell, uint32 msCooldown)
     //if (!msCooldown)
     //    return;
 
-    BotSpellMap::const_iterator itr = _spells.find(basespell);
-    if (itr != _spells.end())
+    if (BotSpell* spell = _FindSpell(basespell))
     {
-        itr->second->cooldown = msCooldown;
+        spell->cooldownEnd = _spellTimeMs + msCooldown;
         return;
     }
     //else if (!msCooldown)
@@ -6673,24 +6787,24 @@ void bot_ai::SetSpellCategoryCooldown(SpellInfo const* spellInfo, uint32 msCoold
         return;
 
     SpellInfo const* info;
-    for (BotSpellMap::const_iterator itr = _spells.begin(); itr != _spells.end(); ++itr)
+    for (BotSpell& spell : _spells)
     {
         //skip spell which has triggered this category cooldown
-        if (itr->first == spellInfo->Id && itr->second->cooldown >= msCooldown)
+        if (spell.baseId == spellInfo->Id && _GetRemainingCooldown(spell) >= msCooldown)
             continue;
 
-        info = sSpellMgr->GetSpellInfo(itr->second->spellId);
+        info = sSpellMgr->GetSpellInfo(spell.spellId);
         info = info ? info->TryGetSpellInfoOverride(me) : info;
-        if (info && itr->first == spellInfo->Id && info->GetCategory() != category && info->StartRecoveryCategory != category)
+        if (info && spell.baseId == spellInfo->Id && info->GetCategory() != category && info->StartRecoveryCategory != category)
         {
-            //if (itr->first != 7814) // Lash of Pain
+            //if (spell.baseId != 7814) // Lash of Pain
             {
                 LOG_ERROR("scripts", "Warning: SetSpellCategoryCooldown: {} has baseId {} but category {}, not {}!",
-                    info->Id, itr->first, info->GetCategory(), category);
+                    info->Id, spell.baseId, info->GetCategory(), category);
             }
         }
-        if (info && (info->GetCategory() == category || info->StartRecoveryCategory == category || itr->first == spellInfo->Id) && itr->second->cooldown < msCooldown)
-            itr->second->cooldown = msCooldown;
+        if (info && (info->GetCategory() == category || info->StartRecoveryCategory == category || spell.baseId == spellInfo->Id) && _GetRemainingCooldown(spell) < msCooldown)
+            spell.cooldownEnd = _spellTimeMs + msCooldown;
     }
 }
 //Handles spell cooldowns for spell with IsCooldownStartedOnEvent() == true
@@ -6718,24 +6832,15 @@ void bot_ai::ReleaseSpellCooldown(uint32 basespell)
 //Using first-rank spell as source, disables certain spell for this bot
 void bot_ai::RemoveSpell(uint32 basespell)
 {
-    BotSpell* newSpell;
-    BotSpellMap::iterator itr = _spells.find(basespell);
-    if (itr == _spells.end())
-    {
-        newSpell = new BotSpell();
-        _spells[basespell] = newSpell;
-    }
-    else
-        newSpell = itr->second;
-
-    newSpell->spellId = 0;
-    newSpell->cooldown = 0;
+    BotSpell& newSpell = _AddSpell(basespell);
+    newSpell.spellId = 0;
+    newSpell.cooldownEnd = 0;
 }
 //
 //void bot_ai::RemoveAllSpells()
 //{
-//    for (BotSpellMap::const_iterator itr = _spells.begin(); itr != _spells.end(); ++itr)
-//        itr->second->spellId = 0;
+//    for (BotSpell& spell : _spells)
+//        spell.spellId = 0;
 //}
 void bot_ai::EnableAllSpells()
 {
@@ -6743,21 +6848,70 @@ void bot_ai::EnableAllSpells()
     npcBotData->disabled_spells.clear();
     _saveDisabledSpells = true;
 
-    for (BotSpellMap::const_iterator itr = _spells.begin(); itr != _spells.end(); ++itr)
-        if (itr->second->enabled == false)
-            itr->second->enabled = true;
+    for (BotSpell& spell : _spells)
+        if (spell.enabled == false)
+            spell.enabled = true;
 }
 //See CommonTimers(uint32)
+//Cooldowns are absolute expiry times, so only the spell clock needs to advance
 void bot_ai::SpellTimers(uint32 diff)
 {
-    // spell must be initialized!!!
-    for (BotSpellMap::const_iterator itr = _spells.begin(); itr != _spells.end(); ++itr)
+    _spellTimeMs += diff;
+}
+static inline uint32 BotSpellIndexHash(uint32 basespell)
+{
+    uint32 h = basespell * 0x9E3779B1u;
+    return h ^ (h >> 16);
+}
+bot_ai::BotSpell const* bot_ai::_FindSpell(uint32 basespell) const
+{
+    if (_spellIndex.empty())
+        return nullptr;
+
+    uint32 mask = uint32(_spellIndex.size()) - 1;
+    for (uint32 i = BotSpellIndexHash(basespell) & mask; _spellIndex[i]; i = (i + 1) & mask)
+    {
+        BotSpell const& spell = _spells[_spellIndex[i] - 1];
+        if (spell.baseId == basespell)
+            return &spell;
+    }
+    return nullptr;
+}
+bot_ai::BotSpell* bot_ai::_FindSpell(uint32 basespell)
+{
+    return const_cast<BotSpell*>(std::as_const(*this)._FindSpell(basespell));
+}
+//Spells are only added during init and by occasional item/racial/forced cooldown spells
+bot_ai::BotSpell& bot_ai::_AddSpell(uint32 basespell)
+{
+    if (BotSpell* spell = _FindSpell(basespell))
+        return *spell;
+
+    _spells.emplace_back(basespell);
+
+    //keep index at most half full
+    if (_spells.size() * 2 > _spellIndex.size())
+    {
+        _spellIndex.assign(std::max<size_t>(_spellIndex.size() * 2, 64), 0);
+        uint32 mask = uint32(_spellIndex.size()) - 1;
+        for (size_t j = 0; j != _spells.size(); ++j)
+        {
+            uint32 i = BotSpellIndexHash(_spells[j].baseId) & mask;
+            while (_spellIndex[i])
+                i = (i + 1) & mask;
+            _spellIndex[i] = uint16(j + 1);
+        }
+    }
+    else
     {
-        if (itr->second->cooldown >= diff)
-            itr->second->cooldown -= diff;
-        else if (itr->second->cooldown > 0)
-            itr->second->cooldown = 0;
+        uint32 mask = uint32(_spellIndex.size()) - 1;
+        uint32 i = BotSpellIndexHash(basespell) & mask;
+        while (_spellIndex[i])
+            i = (i + 1) & mask;
+        _spellIndex[i] = uint16(_spells.size());
     }
+
+    return _spells.back();
 }
 uint32 bot_ai::RaceSpellForClass(uint8 myrace, uint8 myclass)
 {
@@ -7225,9 +7379,11 @@ void bot_ai::OnSpellHit(Unit* caster, SpellInfo const* spell)
             auraname == SPELL_AURA_MOD_TOTAL_STAT_PERCENTAGE || auraname == SPELL_AURA_MOD_SKILL ||
             auraname == SPELL_AURA_MOD_ATTACK_POWER || auraname == SPELL_AURA_MOD_ATTACK_POWER_PCT ||
             auraname == SPELL_AURA_MOD_ATTACK_POWER_OF_STAT_PERCENT || auraname == SPELL_AURA_MOD_ATTACK_POWER_OF_ARMOR ||
-            auraname == SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT ||
-            auraname == SPELL_AURA_MOD_RATING || auraname == SPELL_AURA_MOD_RATING_FROM_STAT)
+            auraname == SPELL_AURA_MOD_SPELL_DAMAGE_OF_STAT_PERCENT)
             shouldUpdateStats = true;
+        //ratings do not affect other stats, only rating based part needs an update
+        else if (auraname == SPELL_AURA_MOD_RATING || auraname == SPELL_AURA_MOD_RATING_FROM_STAT)
+            shouldUpdateRatings = true;
         else if (auraname == SPELL_AURA_MOD_INCREASE_HEALTH ||
             auraname == SPELL_AURA_MOD_INCREASE_HEALTH_2 ||
             auraname == SPELL_AURA_230 ||//SPELL_AURA_MOD_INCREASE_HEALTH_2 blood pact, commanding shout
@@ -7346,8 +7502,16 @@ bool bot_ai::Wait()
     if (waitTimer > lastdiff || !master->IsInWorld())
         return true;
 
+    bool priority = !IAmFree() || me->IsInCombat() || me->GetVictim() || me->GetMap()->IsBattlegroundOrArena();
+    if (!BotUpdateScheduler::Admit(me, priority))
+        return true;
+
+    _updateAdmitted = true;
+
+    //owned bots are always admitted so they keep their throttling,
+    //free bots are capped by update scheduler budget so only keep the reaction randomization part
     if (IAmFree())
-        waitTimer = (me->IsInCombat() || me->GetVictim() || me->GetMap()->IsBattlegroundOrArena()) ? 500 : ((__rand + 100) * 20);
+        waitTimer = priority ? 500 : BotUpdateScheduler::IsEnabled() ? ((__rand + 50) * 10) : ((__rand + 100) * 20);
     else if (!master->GetMap()->IsRaid())
         waitTimer = std::min<uint32>(uint32(50 * (master->GetNpcBotsCount() - 1) + __rand), 500);
     else
@@ -7357,6 +7521,39 @@ bool bot_ai::Wait()
 
     return false;
 }
+
+//Wanderer can drop to travel-only mode if idle on a continent with no players within visibility range
+bool bot_ai::CanUseTravelOnlyMode() const
+{
+    if (!BotMgr::IsWanderingBotsTravelOnlyModeEnabled())
+        return false;
+    if (!IsWanderer() || !IAmFree() || !me->IsInWorld() || !me->IsAlive())
+        return false;
+    if (!me->GetMap()->GetEntry()->IsContinent() || GetBG())
+        return false;
+    if (me->IsInCombat() || me->GetVictim() || IsCasting() || !me->getAttackers().empty())
+        return false;
+
+    //keep some margin so bots are back to normal before they can be seen
+    float range = me->GetVisibilityRange() + 50.0f;
+    Map::PlayerList const& players = me->GetMap()->GetPlayers();
+    for (Map::PlayerList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+    {
+        Player const* player = itr->GetSource();
+        if (player->IsInWorld() && me->IsWithinDist(player, range, false))
+            return false;
+    }
+
+    return true;
+}
+
+void bot_ai::OnUpdateCostMeasured(uint32 costUs)
+{
+    _updateAdmitted = false;
+    _updateCost = _updateCost ? (_updateCost * 7 + costUs) / 8 : costUs;
+    if (me->IsInWorld())
+        BotUpdateScheduler::OnUpdated(me, costUs);
+}
 //Spell Mod Hooks
 void bot_ai::ApplyBotDamageMultiplierMelee(uint32& damage, CalcDamageInfo& damageinfo) const
 {
@@ -9596,10 +9793,9 @@ bool bot_ai::OnGossipSelect(Player* player, Creature* creature/* == me*/, uint32
 
             uint32 basespell;
             SpellInfo const* spellInfo;
-            BotSpellMap const& myspells = GetSpellMap();
-            for (BotSpellMap::const_iterator itr = myspells.begin(); itr != myspells.end(); ++itr)
+            for (BotSpell const& spell : _spells)
             {
-                basespell = itr->first; //always valid
+                basespell = spell.baseId; //always valid
                 if (!CanUseManually(basespell)) continue;
                 if (!IsSpellReady(basespell, lastdiff, false)) continue;
                 spellInfo = sSpellMgr->GetSpellInfo(basespell); //always valid
@@ -9636,20 +9832,15 @@ bool bot_ai::OnGossipSelect(Player* player, Creature* creature/* == me*/, uint32
             NpcBotData* npcBotData = const_cast<NpcBotData*>(BotDataMgr::SelectNpcBotData(me->GetEntry()));
 
             uint32 basespell = action - GOSSIP_ACTION_INFO_DEF;
-            BotSpellMap const& myspells = GetSpellMap();
-            for (BotSpellMap::const_iterator itr = myspells.begin(); itr != myspells.end(); ++itr)
+            if (BotSpell* spell = _FindSpell(basespell))
             {
-                if (itr->first == basespell)
-                {
-                    itr->second->enabled = !itr->second->enabled;
-                    if (itr->second->enabled)
-                        npcBotData->disabled_spells.erase(basespell);
-                    else
-                        npcBotData->disabled_spells.insert(basespell);
+                spell->enabled = !spell->enabled;
+                if (spell->enabled)
+                    npcBotData->disabled_spells.erase(basespell);
+                else
+                    npcBotData->disabled_spells.insert(basespell);
 
-                    _saveDisabledSpells = true;
-                    break;
-                }
+                _saveDisabledSpells = true;
             }
 
             uint32 newSender;
@@ -10542,19 +10733,18 @@ bool bot_ai::OnGossipSelect(Player* player, Creature* creature/* == me*/, uint32
                     ch.PSendSysMessage("%s's Spells:", me->GetName().c_str());
                     uint32 counter = 0;
                     SpellInfo const* spellInfo;
-                    BotSpellMap const& myspells = GetSpellMap();
-                    for (BotSpellMap::const_iterator itr = myspells.begin(); itr != myspells.end(); ++itr)
+                    for (BotSpell const& spell : _spells)
                     {
-                        //if (itr->second->spellId == 0)
+                        //if (spell.spellId == 0)
                         //    continue;
 
                         ++counter;
                         std::ostringstream sstr;
-                        spellInfo = sSpellMgr->GetSpellInfo(itr->first); //always valid
+                        spellInfo = sSpellMgr->GetSpellInfo(spell.baseId); //always valid
                         _AddSpellLink(player, spellInfo, sstr);
-                        sstr << " id: " <<  itr->second->spellId << ", base: " << itr->first
-                            << ", cd: " << itr->second->cooldown << ", base: " << std::max<uint32>(spellInfo->RecoveryTime, spellInfo->CategoryRecoveryTime);
-                        if (itr->second->enabled == false)
+                        sstr << " id: " <<  spell.spellId << ", base: " << spell.baseId
+                            << ", cd: " << _GetRemainingCooldown(spell) << ", base: " << std::max<uint32>(spellInfo->RecoveryTime, spellInfo->CategoryRecoveryTime);
+                        if (spell.enabled == false)
                             sstr << " (disabled)";
                         ch.PSendSysMessage("%u) %s", counter, sstr.str().c_str());
                     }
@@ -12412,6 +12602,7 @@ bool bot_ai::_equip(uint8 slot, Item* newItem, ObjectGuid receiver)
 void bot_ai::_updateEquips(uint8 slot, Item* item)
 {
     _equips[slot] = item;
+    _gearScoresValid = false;
     BotDataMgr::UpdateNpcBotData(me->GetEntry(), NPCBOT_UPDATE_EQUIPS, _equips);
 }
 //Called from gossip menu only (applies only to weapons)
@@ -12567,6 +12758,8 @@ void bot_ai::ApplyItemBonuses(uint8 slot)
 
 void bot_ai::RemoveItemBonuses(uint8 slot)
 {
+    _gearScoresValid = false;
+
     Item* item = _equips[slot];
     if (!item)
         return;
@@ -13804,7 +13997,15 @@ float bot_ai::GetAverageItemLevel() const
 }
 std::pair<float, float> bot_ai::GetBotGearScores() const
 {
-    return CalculateBotGearScore(me->GetEntry(), me->GetLevel(), GetBotClass(), GetSpec(), _equips);
+    //cached until equipment, level or spec changes
+    if (!_gearScoresValid || _gearScoresLevel != me->GetLevel() || _gearScoresSpec != GetSpec())
+    {
+        _gearScores = CalculateBotGearScore(me->GetEntry(), me->GetLevel(), GetBotClass(), GetSpec(), _equips);
+        _gearScoresLevel = me->GetLevel();
+        _gearScoresSpec = GetSpec();
+        _gearScoresValid = true;
+    }
+    return _gearScores;
 }
 /////////
 //ROLES//
@@ -15650,23 +15851,23 @@ void bot_ai::OnBotSpellInterrupted(SpellSchoolMask schoolMask, uint32 unTimeMs)
 {
     SpellInfo const* info;
 
-    for (BotSpellMap::const_iterator itr = _spells.begin(); itr != _spells.end(); ++itr)
+    for (BotSpell& spell : _spells)
     {
-        info = sSpellMgr->GetSpellInfo(itr->second->spellId);
+        info = sSpellMgr->GetSpellInfo(spell.spellId);
         if (!info || !(info->GetSchoolMask() & schoolMask)) continue;
         if (info->IsCooldownStartedOnEvent()) continue;
         if (info->PreventionType != SPELL_PREVENTION_TYPE_SILENCE) continue;
 
         if (HasBotCommandState(BOT_COMMAND_ISSUED_ORDER) &&
             !_orders.empty() && _orders.front()._type == BOT_ORDER_SPELLCAST &&
-            _orders.front().params.spellCastParams.baseSpell == itr->first)
+            _orders.front().params.spellCastParams.baseSpell == spell.baseId)
         {
             if (DEBUG_BOT_ORDERS)
                 LOG_ERROR("entities.player", "doCast(): ordered spell {} was interrupted!", info->Id);
             CompleteOrder(_orders.front());
         }
 
-        itr->second->cooldown += unTimeMs;
+        spell.cooldownEnd = std::max<uint64>(spell.cooldownEnd, _spellTimeMs) + unTimeMs;
         //TC_LOG_ERROR("entities.player", "OnBotSpellInterrupted(): Adding cooldown (%u, new: %u) to spell %s (id: %u, schoolmask: %u), reqSchoolMask = %u",
         //    unTimeMs, itr->second.second, info->SpellName[0], info->Id, info->SchoolMask, schoolMask);
     }
@@ -15949,7 +16150,7 @@ void bot_ai::_ProcessOrders()
             if (IsCasting())
                 me->InterruptNonMeleeSpells(false);
 
-            doCast(target, _spells[order.params.spellCastParams.baseSpell]->spellId);
+            doCast(target, ASSERT_NOTNULL(_FindSpell(order.params.spellCastParams.baseSpell))->spellId);
             break;
         }
         default:
@@ -16890,6 +17091,39 @@ bool bot_ai::GlobalUpdate(uint32 diff)
     if (IsDuringTeleport())
         return false;
 
+    //travel-only mode: wanderers nobody can see skip class AI and only move along node links with coarse updates
+    if (IsWanderer() && _travelOnlyCheckTimer <= diff)
+    {
+        _travelOnlyCheckTimer = BOT_TRAVEL_ONLY_CHECK_TIMER;
+        bool travelOnly = CanUseTravelOnlyMode();
+        if (travelOnly != _travelOnly)
+        {
+            LOG_TRACE("npcbots", "Bot {} id {} {} travel-only mode", me->GetName().c_str(), me->GetEntry(), travelOnly ? "enters" : "leaves");
+            _travelOnly = travelOnly;
+            _travelOnlyElapsed = 0;
+        }
+    }
+    if (_travelOnly)
+    {
+        _travelOnlyElapsed += diff;
+        if (_travelOnlyUpdateTimer > diff)
+            return false;
+
+        _travelOnlyUpdateTimer = BOT_TRAVEL_ONLY_UPDATE_TIMER;
+        lastdiff = _travelOnlyElapsed;
+        _travelOnlyElapsed = 0;
+
+        if (!me->IsAlive() || !me->IsInWorld())
+            return false;
+
+        if (!IsTempBot())
+            Regenerate();
+        if (!me->GetVictim())
+            Evade();
+
+        return false;
+    }
+
     lastdiff = diff;
 
     if (_updateTimerMedium <= diff)
@@ -17413,6 +17647,8 @@ bool bot_ai::GlobalUpdate(uint32 diff)
         }
         if (shouldUpdateStats && me->GetPhaseMask() == master->GetPhaseMask())
             SetStats(false);
+        else if (shouldUpdateRatings && me->GetPhaseMask() == master->GetPhaseMask())
+            UpdateRatingStats();
         else if (_powersTimer <= lastdiff && !IsTempBot())
         {
             _powersTimer += REGEN_CD; //do not mistake for regen, this is only for updating max health/mana
@@ -17536,12 +17772,16 @@ bool bot_ai::GlobalUpdate(uint32 diff)
 
 void bot_ai::CommonTimers(uint32 diff)
 {
+    BotDecisionPipeline::OnBotUpdate(me, diff);
+
     Events.Update(diff);
     SpellTimers(diff);
 
     if (GC_Timer > diff)            GC_Timer -= diff;
     if (checkAurasTimer > diff)     checkAurasTimer -= diff;
     if (waitTimer > diff)           waitTimer -= diff;
+    if (_travelOnlyCheckTimer > diff)   _travelOnlyCheckTimer -= diff;
+    if (_travelOnlyUpdateTimer > diff)  _travelOnlyUpdateTimer -= diff;
     if (_moveBehindTimer > diff)    _moveBehindTimer -= diff;
     if (itemsAutouseTimer > diff)   itemsAutouseTimer -= diff;
     if (evadeDelayTimer > diff)     evadeDelayTimer -= diff;
@@ -35,6 +35,7 @@ class Aura;
 class Battleground;
 class DamageInfo;
 class GameObject;
+class BotHealQueue;
 class Group;
 class Item;
 class Spell;
@@ -73,6 +74,8 @@ class bot_ai : public CreatureAI
         virtual void OnBotDamageTaken(Unit* /*attacker*/, uint32 /*damage*/, CleanDamage const* /*cleanDamage*/, DamageEffectType /*damagetype*/, SpellInfo const* /*spellInfo*/) {}
         virtual void OnBotDamageDealt(Unit* /*victim*/, uint32 /*damage*/, CleanDamage const* /*cleanDamage*/, DamageEffectType /*damagetype*/, SpellInfo const* /*spellInfo*/) {}
         virtual void OnBotDispelDealt(Unit* /*dispelled*/, uint8 /*num*/) {}
+        void OnBotAuraApplied(Unit const* target, uint32 spellId);
+        void OnBotAuraRemoved(Unit const* target, uint32 spellId);
 
         //bool OnGossipHello(Player* player) override;
         //bool OnGossipSelect(Player* player, uint32 menuId, uint32 gossipListId) override;
@@ -107,6 +110,12 @@ class bot_ai : public CreatureAI
         void CheckOwnerExpiry();
         uint8 GetBotClass() const { return _botclass; }
         uint32 GetLastDiff() const { return lastdiff; }
+        //update scheduler: average cost of a full AI update (microseconds)
+        bool IsUpdateAdmitted() const { return _updateAdmitted; }
+        uint32 GetUpdateCost() const { return _updateCost; }
+        void OnUpdateCostMeasured(uint32 costUs);
+        //decision pipeline: read-only preparation for upcoming update, may run on a worker thread
+        void PrepareUpdate(uint32 diff) const;
         virtual void UpdateDeadAI(uint32 diff);
         void ReturnHome() { _atHome = false; }
         void CommonTimers(uint32 diff);
@@ -165,6 +174,7 @@ class bot_ai : public CreatureAI
 
         //wandering bots
         bool IsWanderer() const { return _wanderer; }
+        bool IsTravelOnly() const { return _travelOnly; }
         void SetWanderer();
         WanderNode const* GetNextTravelNode(Position const* from, bool random) const;
         WanderNode const* GetNextBGTravelNode() const;
@@ -313,6 +323,7 @@ class bot_ai : public CreatureAI
 
         AoeSpotsVec const& GetAoeSpots() const;
         static void CalculateAoeSpots(Unit const* unit, AoeSpotsVec& spots);
+        static bool IsPeriodicDynObjAOEDamage(SpellInfo const* spellInfo);
         void CalculateAoeSafeSpots(Unit* target, float maxdist, AoeSafeSpotsVec& safespots) const;
 
         //Pet stuff
@@ -358,6 +369,7 @@ class bot_ai : public CreatureAI
         void ResurrectGroup(uint32 REZZ);
         void CureGroup(uint32 cureSpell, uint32 diff);
         void SetStats(bool force);
+        void UpdateRatingStats();
         void DefaultInit();
         void InitUnitFlags(); // call only in constructor
 
@@ -426,7 +438,6 @@ class bot_ai : public CreatureAI
 
         float CalcSpellMaxRange(uint32 spellId, bool enemy = true) const;
 
-        static bool IsPeriodicDynObjAOEDamage(SpellInfo const* spellInfo);
         bool IsWithinAoERadius(Position const& pos) const;
 
         float InitAttackRange(float origRange, bool ranged) const;
@@ -449,6 +460,14 @@ class bot_ai : public CreatureAI
         Unit* FindUndeadCCTarget(float dist, uint32 spellId, bool unattacked = true) const;
         Unit* FindRootTarget(float dist, uint32 spellId) const;
         Unit* FindCastingTarget(float maxdist = 10, float mindist = 0, uint32 spellId = 0, uint8 minHpPct = 0) const;
+
+        enum BotHostileScanBuckets
+        {
+            BOT_HOSTILE_SCAN_ENGAGED                = 0, //in combat: CC and dispel candidates
+            BOT_HOSTILE_SCAN_CASTING                = 1, //casting non-friendly units: interrupt candidates
+            MAX_BOT_HOSTILE_SCAN_BUCKETS
+        };
+        std::vector<Unit*> const& GetHostileScanBucket(BotHostileScanBuckets bucket, float dist) const;
         Unit* FindAOETarget(float dist, WorldObject const* src = nullptr) const;
         Unit* FindSplashTarget(float dist = 5, Unit* To = nullptr, float splashdist = 4) const;
         Unit* FindSplashTarget(float dist, Unit* To, float splashdist, uint8 minTargets) const;
@@ -490,6 +509,7 @@ class bot_ai : public CreatureAI
         uint32 GetRation(bool drink) const;
 
         bool Wait();
+        bool CanUseTravelOnlyMode() const;
         uint16 Rand() const;
         void GenerateRand() const;
 
@@ -559,9 +579,12 @@ class bot_ai : public CreatureAI
         void FindMaster();
 
         void _OnHealthUpdate() const;
+        void _SetRatingStats(uint8 mylevel, uint8 myclass);
         void _OnManaUpdate() const;
         void _OnManaRegenUpdate() const;
 
+        void _FillHealQueue(BotHealQueue& queue, Group const* pGroup) const;
+
         void _UpdateWMOArea();
         void _OnZoneUpdate(uint32 zoneId, uint32 areaId);
         void _OnAreaUpdate(uint32 areaId);
@@ -660,6 +683,13 @@ class bot_ai : public CreatureAI
         Position homepos, movepos, attackpos, sendlastpos;
         Position sendpos[MAX_SEND_POINTS];
         AoeSpotsVec _aoeSpots;
+        //targets of auras applied by me, see FindAffectedTarget()
+        typedef std::unordered_map<uint32 /*spellId*/, std::vector<ObjectGuid> /*targets*/> AuraTargetsMap;
+        AuraTargetsMap _auraTargets;
+        //classified neighborhood shared by Find*Target() functions, valid for one tick
+        mutable std::vector<Unit*> _hostileScan[MAX_BOT_HOSTILE_SCAN_BUCKETS];
+        mutable uint32 _hostileScanTick;
+        mutable float _hostileScanRange;
 
         uint32 _botCommandState;
         uint8 _botAwaitState;
@@ -675,6 +705,8 @@ class bot_ai : public CreatureAI
         uint32 _moveBehindTimer;
         uint32 _wmoAreaUpdateTimer;
         uint32 waitTimer;
+        uint32 _updateCost;
+        bool _updateAdmitted;
         uint32 itemsAutouseTimer;
         uint32 evadeDelayTimer;
         uint32 indoorsTimer;
@@ -691,7 +723,10 @@ class bot_ai : public CreatureAI
         uint32 _usableItemSlotsMask;
         ObjectGuid::LowType _ownerGuid;
         ObjectGuid _lastTargetGuid;
-        bool doHealth, doMana, shouldUpdateStats;
+        mutable std::pair<float, float> _gearScores;
+        mutable uint8 _gearScoresLevel, _gearScoresSpec;
+        mutable bool _gearScoresValid;
+        bool doHealth, doMana, shouldUpdateStats, shouldUpdateRatings;
         bool feast_health, feast_mana;
         bool spawned;
         bool firstspawn;
@@ -704,6 +739,11 @@ class bot_ai : public CreatureAI
         uint8 _baseLevel;
         WanderNode const* _travel_node_last;
         WanderNode const* _travel_node_cur;
+        //travel-only mode (no players around)
+        bool _travelOnly;
+        uint32 _travelOnlyCheckTimer;
+        uint32 _travelOnlyUpdateTimer;
+        uint32 _travelOnlyElapsed;
 
         uint32 _groupUpdateMask;
         uint64 _auraRaidUpdateMask;
@@ -726,28 +766,34 @@ class bot_ai : public CreatureAI
         TeleportFinishEvent* teleFinishEvent;
         AwaitStateRemovalEvent* awaitStateRemEvent;
 
+        typedef int32 ItemStatBonus[MAX_BOT_ITEM_MOD];
+        ItemStatBonus _stats[BOT_INVENTORY_SIZE];
+        Item* _equips[BOT_INVENTORY_SIZE];
+
+    public:
+        //cooldowns are stored as absolute expiry time on bot's spell clock (_spellTimeMs)
         struct BotSpell
         {
-            BotSpell() : spellId(0), cooldown(0), enabled(true) {}
-            BotSpell(BotSpell const&) = delete;
-            BotSpell(BotSpell&&) = delete;
-            BotSpell& operator=(BotSpell const&) = delete;
-            BotSpell& operator=(BotSpell&&) = delete;
+            explicit BotSpell(uint32 base) : baseId(base), spellId(0), cooldownEnd(0), enabled(true) {}
+            uint32 baseId;
             uint32 spellId;
-            uint32 cooldown;
+            uint64 cooldownEnd;
             bool enabled;
         };
 
-        typedef int32 ItemStatBonus[MAX_BOT_ITEM_MOD];
-        ItemStatBonus _stats[BOT_INVENTORY_SIZE];
-        Item* _equips[BOT_INVENTORY_SIZE];
-
-    public:
-        typedef std::unordered_map<uint32 /*firstrankspellid*/, BotSpell* /*spell*/> BotSpellMap;
-        BotSpellMap const& GetSpellMap() const { return _spells; }
+        typedef std::vector<BotSpell> BotSpellTable;
+        BotSpellTable const& GetSpellTable() const { return _spells; }
 
     private:
-        BotSpellMap _spells;
+        BotSpell* _FindSpell(uint32 basespell);
+        BotSpell const* _FindSpell(uint32 basespell) const;
+        BotSpell& _AddSpell(uint32 basespell);
+        uint32 _GetRemainingCooldown(BotSpell const& spell) const { return spell.cooldownEnd > _spellTimeMs ? uint32(spell.cooldownEnd - _spellTimeMs) : 0; }
+
+        //dense spell slots plus open addressing index (basespell -> slot + 1), no per-spell allocations
+        BotSpellTable _spells;
+        std::vector<uint16> _spellIndex;
+        uint64 _spellTimeMs;
 
     public:
         //much simplier than SmartAI I guess...
@@ -381,18 +381,17 @@ public:
         {
             if (damage)
             {
-                BotSpellMap const& spells = GetSpellMap();
-                for (BotSpellMap::const_iterator itr = spells.begin(); itr != spells.end(); ++itr)
+                for (BotSpell const& spell : GetSpellTable())
                 {
                     //not affected if pet is alive
-                    if (botPet && itr->first == INFERNO_1)
+                    if (botPet && spell.baseId == INFERNO_1)
                         continue;
 
-                    uint32& cooldown = itr->second->cooldown;
+                    uint32 cooldown = GetSpellCooldown(spell.baseId);
                     if (!cooldown)
                         continue;
 
-                    cooldown = cooldown > DAMAGE_CD_REDUCTION ? cooldown - DAMAGE_CD_REDUCTION : 0;
+                    SetSpellCooldown(spell.baseId, cooldown > DAMAGE_CD_REDUCTION ? cooldown - DAMAGE_CD_REDUCTION : 0);
                 }
             }
 
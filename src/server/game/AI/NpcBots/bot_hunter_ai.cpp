@@ -1509,16 +1509,15 @@ public:
             if (baseId == READINESS_1)
             {
                 SpellInfo const* cdInfo;
-                BotSpellMap const& myspells = GetSpellMap();
-                for (BotSpellMap::const_iterator itr = myspells.begin(); itr != myspells.end(); ++itr)
+                for (BotSpell const& spell : GetSpellTable())
                 {
-                    if (itr->first == spellInfo->Id || itr->first == BESTIAL_WRATH_1 || itr->first == GIFT_OF_NAARU_HUNTER)
+                    if (spell.baseId == spellInfo->Id || spell.baseId == BESTIAL_WRATH_1 || spell.baseId == GIFT_OF_NAARU_HUNTER)
                         continue;
-                    if (itr->second->spellId != 0 && itr->second->cooldown > 0)
+                    if (spell.spellId != 0 && GetSpellCooldown(spell.baseId) > 0)
                     {
-                        cdInfo = sSpellMgr->GetSpellInfo(itr->first);
+                        cdInfo = sSpellMgr->GetSpellInfo(spell.baseId);
                         if (cdInfo && cdInfo->SpellFamilyName == SPELLFAMILY_HUNTER && cdInfo->GetRecoveryTime() > 0)
-                            ResetSpellCooldown(itr->first);
+                            ResetSpellCooldown(spell.baseId);
                     }
                 }
             }
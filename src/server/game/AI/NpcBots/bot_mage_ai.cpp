@@ -1335,17 +1335,16 @@ public:
             if (baseId == COLD_SNAP_1)
             {
                 SpellInfo const* cdInfo;
-                BotSpellMap const& myspells = GetSpellMap();
-                for (BotSpellMap::const_iterator itr = myspells.begin(); itr != myspells.end(); ++itr)
+                for (BotSpell const& spell : GetSpellTable())
                 {
-                    if (itr->first == baseId)
+                    if (spell.baseId == baseId)
                         continue;
-                    if (itr->second->spellId != 0 && itr->second->cooldown > 0)
+                    if (spell.spellId != 0 && GetSpellCooldown(spell.baseId) > 0)
                     {
-                        cdInfo = sSpellMgr->GetSpellInfo(itr->first);
+                        cdInfo = sSpellMgr->GetSpellInfo(spell.baseId);
                         if (cdInfo && cdInfo->SpellFamilyName == SPELLFAMILY_MAGE && cdInfo->GetRecoveryTime() > 0 &&
                             (cdInfo->GetSchoolMask() & SPELL_SCHOOL_MASK_FROST))
-                            ResetSpellCooldown(itr->first);
+                            ResetSpellCooldown(spell.baseId);
                     }
                 }
             }
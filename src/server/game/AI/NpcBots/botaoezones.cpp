@@ -0,0 +1,103 @@
+#include "bot_ai.h"
+#include "botaoezones.h"
+#include "CellImpl.h"
+#include "DynamicObject.h"
+#include "Map.h"
+#include "SpellMgr.h"
+
+#include <mutex>
+
+/*
+Name: botaoezones
+%Complete: 100
+Comment: Per-map harmful AoE zone registry for NPCBot positioning
+*/
+
+#ifdef _MSC_VER
+# pragma warning(push, 4)
+#endif
+
+namespace
+{
+
+//Dynamic objects do not move (except farsight ones which are not area spells), so cell is fixed
+uint32 GetZoneCellId(DynamicObject const* dynObj)
+{
+    CellCoord p(Acore::ComputeCellCoord(dynObj->GetPositionX(), dynObj->GetPositionY()));
+    return p.GetId();
+}
+
+}
+
+void BotAoeZoneRegistry::OnDynObjectAdded(DynamicObject* dynObj)
+{
+    if (dynObj->GetByteValue(DYNAMICOBJECT_BYTES, 0) != DYNAMIC_OBJECT_AREA_SPELL || !dynObj->GetSpellId())
+        return;
+
+    SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(dynObj->GetSpellId());
+    if (!spellInfo || !bot_ai::IsPeriodicDynObjAOEDamage(spellInfo))
+        return;
+
+    BotAoeZoneRegistry* zones = dynObj->GetMap()->GetBotAoeZones();
+    std::unique_lock<std::shared_mutex> lock(zones->_lock);
+    zones->_cells[GetZoneCellId(dynObj)].push_back(dynObj);
+    ++zones->_count;
+}
+
+void BotAoeZoneRegistry::OnDynObjectRemoved(DynamicObject* dynObj)
+{
+    BotAoeZoneRegistry* zones = dynObj->GetMap()->GetBotAoeZones();
+    std::unique_lock<std::shared_mutex> lock(zones->_lock);
+    if (!zones->_count)
+        return;
+
+    auto itr = zones->_cells.find(GetZoneCellId(dynObj));
+    if (itr == zones->_cells.end())
+        return;
+
+    std::vector<DynamicObject*>& cellZones = itr->second;
+    auto zitr = std::find(cellZones.begin(), cellZones.end(), dynObj);
+    if (zitr == cellZones.end())
+        return;
+
+    *zitr = cellZones.back();
+    cellZones.pop_back();
+    --zones->_count;
+    if (cellZones.empty())
+        zones->_cells.erase(itr);
+}
+
+void BotAoeZoneRegistry::GetZonesInRange(WorldObject const* center, float radius, std::vector<DynamicObject*>& zones)
+{
+    BotAoeZoneRegistry const* zoneMap = center->GetMap()->GetBotAoeZones();
+    std::shared_lock<std::shared_mutex> lock(zoneMap->_lock);
+    if (!zoneMap->_count)
+        return;
+
+    CellArea area = Cell::CalculateCellArea(center->GetPositionX(), center->GetPositionY(), radius);
+    //fewer zones than cells to check, just go through all of them
+    if (zoneMap->_cells.size() <= (area.high_bound.x_coord - area.low_bound.x_coord + 1) * (area.high_bound.y_coord - area.low_bound.y_coord + 1))
+    {
+        for (auto const& p : zoneMap->_cells)
+            zones.insert(zones.end(), p.second.begin(), p.second.end());
+        return;
+    }
+
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            CellCoord cellCoord(x, y);
+            if (!cellCoord.IsCoordValid())
+                continue;
+
+            auto itr = zoneMap->_cells.find(cellCoord.GetId());
+            if (itr != zoneMap->_cells.end())
+                zones.insert(zones.end(), itr->second.begin(), itr->second.end());
+        }
+    }
+}
+
+#ifdef _MSC_VER
+# pragma warning(pop)
+#endif
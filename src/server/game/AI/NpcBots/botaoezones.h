@@ -0,0 +1,41 @@
+#ifndef _BOT_AOEZONES_H
+#define _BOT_AOEZONES_H
+
+#include "Define.h"
+
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+class DynamicObject;
+class WorldObject;
+
+/*
+Per-map registry of harmful periodic area spell zones (dynamic objects) for NPCBot positioning.
+Owned by Map (see Map::GetBotAoeZones), so maps never share or wait on each other's registry.
+Zones are registered when dynamic object is added to world and unregistered when it is removed,
+bucketed by grid cell, so bots and owners can look up zones near them without visiting the grid.
+Only spell type is checked on registration (see bot_ai::IsPeriodicDynObjAOEDamage),
+hostility, phase and distance are checked by the caller.
+Registry has its own lock: regions of a continent may add, remove and look up zones in parallel
+*/
+class BotAoeZoneRegistry
+{
+    public:
+        BotAoeZoneRegistry() : _count(0) {}
+
+        static void OnDynObjectAdded(DynamicObject* dynObj);
+        static void OnDynObjectRemoved(DynamicObject* dynObj);
+
+        //Appends registered zones from cells within radius of center
+        static void GetZonesInRange(WorldObject const* center, float radius, std::vector<DynamicObject*>& zones);
+
+    private:
+        BotAoeZoneRegistry(BotAoeZoneRegistry const&);
+
+        std::unordered_map<uint32 /*cellId*/, std::vector<DynamicObject*>> _cells;
+        uint32 _count;
+        mutable std::shared_mutex _lock;
+};
+
+#endif
@@ -1185,7 +1185,7 @@ public:
             return false;
         }
 
-        wp->Relocate(player);
+        wp->SetPosition(player->GetPosition());
         if (Creature* creature = wp->GetCreature())
             creature->NearTeleportTo(*player);
 
@@ -1609,7 +1609,7 @@ public:
         if (!file_str || (!force_kick && sWorld->GetPlayerCount() > 0))
         {
             handler->SendSysMessage(".npcbot dump load");
-            handler->SendSysMessage("Imports NPCBots from a backup SQL file created with '.npcbot dump write' command.");
+            handler->SendSysMessage("Imports NPCBots from a backup file created with '.npcbot dump write' command.");
             handler->SendSysMessage("Syntax: .npcbot dump load #file_name [#force_kick_all]");
             if (!force_kick && sWorld->GetPlayerCount() > 0)
                 handler->SendSysMessage("Make sure no players are online before importing.");
@@ -1621,17 +1621,27 @@ public:
         if (force_kick)
             sWorld->KickAll();
 
-        //omit file ext if needed
+        //omit file ext if needed, old dumps are sql files
         if (file_str->find('.') == std::string::npos)
-            *file_str += ".sql";
+        {
+            if (std::ifstream(*file_str + ".dump"))
+                *file_str += ".dump";
+            else
+                *file_str += ".sql";
+        }
 
-        switch (NPCBotsDump().Load(*file_str))
+        NPCBotsDump dump;
+        switch (dump.Load(*file_str))
         {
             case BOT_DUMP_SUCCESS:
-                handler->SendSysMessage("Import successful.");
+            {
+                BotDataDumpStats const& stats = dump.GetStats();
+                handler->PSendSysMessage("Import successful: %u bots, %u rows, %u KB in %u ms (%u rows/s).",
+                    stats.bots, stats.rows, uint32(stats.bytes / 1024), stats.timeMs, uint32(uint64(stats.rows) * 1000 / std::max<uint32>(stats.timeMs, 1u)));
                 handler->SendSysMessage("Server will be restarted now to prevent DB corruption.");
                 sWorld->ShutdownServ(4, SHUTDOWN_MASK_RESTART, 70);
                 break;
+            }
             case BOT_DUMP_FAIL_FILE_NOT_EXIST:
                 handler->PSendSysMessage("Can't open %s or the file doesn't exist!", file_str->c_str());
                 handler->SetSentErrorMessage(true);
@@ -1657,20 +1667,25 @@ public:
     {
         if (!file_str)
         {
-            handler->SendSysMessage(".npcbot dump write\nExports spawned NPCBots into a SQL file.\nSyntax: .npcbot dump write #file_name");
+            handler->SendSysMessage(".npcbot dump write\nExports spawned NPCBots into a dump file.\nSyntax: .npcbot dump write #file_name");
             handler->SetSentErrorMessage(true);
             return false;
         }
 
         //omit file ext if needed
         if (file_str->find('.') == std::string::npos)
-            *file_str += ".sql";
+            *file_str += ".dump";
 
-        switch (NPCBotsDump().Write(*file_str))
+        NPCBotsDump dump;
+        switch (dump.Write(*file_str))
         {
             case BOT_DUMP_SUCCESS:
-                handler->SendSysMessage("Export successful.");
+            {
+                BotDataDumpStats const& stats = dump.GetStats();
+                handler->PSendSysMessage("Export successful: %u bots, %u rows, %u KB in %u ms (%u rows/s).",
+                    stats.bots, stats.rows, uint32(stats.bytes / 1024), stats.timeMs, uint32(uint64(stats.rows) * 1000 / std::max<uint32>(stats.timeMs, 1u)));
                 break;
+            }
             case BOT_DUMP_FAIL_FILE_ALREADY_EXISTS:
                 handler->PSendSysMessage("File %s already exists!", file_str->c_str());
                 handler->SetSentErrorMessage(true);
@@ -13,6 +13,17 @@ NpcBot System by Trickerer (onlysuffering@gmail.com)
 Original patch from: LordPsyan https://bitbucket.org/lordpsyan/trinitycore-patches/src/3b8b9072280e/Individual/11185-BOTS-NPCBots.patch
 */
 
+/*
+Threading of per-map NpcBot state (grid cache, heal triage, update scheduler, decision pipeline)
+Bot AI runs on the thread updating bot's map. A map is updated by one thread at a time, except continents
+with MapUpdate.Regions.Enable: regions of a continent that are far apart are then updated by several threads
+at once (see Map::UpdateRegions). Regions are never split between bots of one player or group, their pets
+and their victims (see MapRegionLinker), and bots never look further than visibility range, so:
+- per-thread (thread_local) snapshots of a map are only read by bots of regions that thread updates
+- state shared by all threads updating a map must be accessed under MapRegionGuard
+- global containers of per-map state need their own lock
+*/
+
 struct Position;
 
 typedef std::vector<std::pair<Position, float> > AoeSpotsVec;
@@ -47,6 +58,13 @@ enum BotCommonValues
     REVIVE_TIMER_SHORT                  = 60000, //1 Minute
     INOUTDOORS_ENSURE_TIMER             = 1500,
     BOT_GROUP_UPDATE_TIMER              = 2000,
+    BOT_TRAVEL_ONLY_CHECK_TIMER         = 1000,
+    BOT_TRAVEL_ONLY_UPDATE_TIMER        = 1000,
+    BOT_HEAL_TRIAGE_LOOKAHEAD           = 2000, //expected damage taken counts as missing health
+    BOT_HEAL_TRIAGE_MAX_ATTEMPTS        = 2,
+    BOT_DECISION_MIN_BOTS               = 32, //bots per map needed to use decision threads
+    BOT_DECISION_SCAN_KEEP_TIME         = 2000, //bots which scanned for hostiles recently get scan prepared
+    BOT_WANDERER_POPULATION_PER_PLAYER  = 10, //population controller: max wanderers moved into zone per player
 //VEHICLE CREATURES
     CREATURE_NEXUS_SKYTALON_1           = 32535, // [Q] Aces High
     CREATURE_EOE_SKYTALON_N             = 30161, // Eye of Eternity
@@ -44,6 +44,12 @@ NpcBotExtrasMap _botsExtras;
 NpcBotTransmogDataMap _botsTransmogData;
 NpcBotRegistry _existingBots;
 
+//secondary lookup indexes, guarded by BotDataMgr::GetLock()
+typedef std::unordered_map<std::wstring /*lowercase name*/, std::vector<Creature const*>> NpcBotNameIndex;
+std::unordered_map<uint32 /*entry*/, Creature const*> _existingBotsByEntry;
+std::array<NpcBotNameIndex, TOTAL_LOCALES> _existingBotsByName;
+std::unordered_map<uint32 /*owner*/, std::set<uint32 /*entry*/>> _botEntriesByOwner;
+
 std::map<uint32, uint8> _wpMinSpawnLevelPerMapId;
 std::map<uint32, uint8> _wpMaxSpawnLevelPerMapId;
 std::map<uint8, std::set<uint32>> _spareBotIdsPerClassMap;
@@ -52,7 +58,16 @@ std::unordered_map<uint32, EquipmentInfo const*> _botsWanderCreatureEquipmentTem
 std::list<std::pair<uint32, WanderNode const*>> _botsWanderCreaturesToSpawn;
 std::set<uint32> _botsWanderCreaturesToDespawn;
 
+//teleport-viable spawn nodes per team and bot level, rebuilt whenever wander nodes change
+typedef std::vector<WanderNode const*> WanderNodeVec;
+std::array<std::vector<WanderNodeVec>, TEAM_NEUTRAL + 1> _botsWanderSpawnNodesPerTeamLevel;
+static uint32 _botsWanderSpawnNodesGeneration = 0;
+static bool _botsWanderSpawnNodesBuilt = false;
+
 ItemPerBotClassMap _botsWanderCreaturesSortedGear;
+//same pools with templates resolved, read-only after load so item generation needs no lookups or copies
+typedef std::vector<ItemTemplate const*> ItemTemplateVector;
+std::array<std::array<std::array<ItemTemplateVector, LEVEL_STEPS>, BOT_INVENTORY_SIZE>, BOT_CLASS_END> _botsWanderCreaturesSortedGearTemplates;
 
 typedef std::unordered_map<ObjectGuid /*playerGuid*/, BotBankItemContainer> BotGearStorageMap;
 BotGearStorageMap _botStoredGearMap;
@@ -60,10 +75,116 @@ BotGearStorageMap _botStoredGearMap;
 static bool allBotsLoaded = false;
 
 static uint32 next_wandering_bot_spawn_delay = 0;
+static uint32 next_wandering_bot_population_update_delay = 0;
+static uint32 _lastSpawnedWandererMapId = 0;
 
 static EventProcessor botSpawnEvents;
 static std::unordered_map<ObjectGuid, EventProcessor> botBGJoinEvents;
 
+//write-behind for frequently changed npcbot data fields: changes are coalesced per entry and saved in batches
+enum NpcBotDataDirtyFlags : uint8
+{
+    NPCBOT_DATA_DIRTY_ROLES             = 0x01,
+    NPCBOT_DATA_DIRTY_SPEC              = 0x02,
+    NPCBOT_DATA_DIRTY_FACTION           = 0x04,
+    NPCBOT_DATA_DIRTY_DISABLED_SPELLS   = 0x08
+};
+static std::unordered_map<uint32 /*entry*/, uint8 /*NpcBotDataDirtyFlags*/> _botsDataDirty;
+static std::mutex _botsDataDirtyLock;
+static uint32 next_bot_data_save_delay = 0;
+
+static void IndexBotOwner(uint32 entry, uint32 oldOwner, uint32 newOwner)
+{
+    if (oldOwner == newOwner)
+        return;
+
+    if (oldOwner)
+    {
+        auto itr = _botEntriesByOwner.find(oldOwner);
+        if (itr != _botEntriesByOwner.end())
+        {
+            itr->second.erase(entry);
+            if (itr->second.empty())
+                _botEntriesByOwner.erase(itr);
+        }
+    }
+    if (newOwner)
+        _botEntriesByOwner[newOwner].insert(entry);
+}
+
+//Calls func(locale, lowercase_name) for every locale using localized creature name if any
+template<typename F>
+static void DoForBotNamePerLocale(Creature const* bot, F&& func)
+{
+    std::wstring wbasename;
+    if (!Utf8toWStr(bot->GetName(), wbasename))
+        return;
+    wstrToLower(wbasename);
+
+    CreatureLocale const* creatureInfo = sObjectMgr->GetCreatureLocale(bot->GetEntry());
+    for (uint8 loc = LOCALE_enUS; loc != TOTAL_LOCALES; ++loc)
+    {
+        if (creatureInfo && creatureInfo->Name.size() > loc && !creatureInfo->Name[loc].empty())
+        {
+            std::wstring wlocname;
+            if (Utf8toWStr(creatureInfo->Name[loc], wlocname))
+            {
+                wstrToLower(wlocname);
+                func(LocaleConstant(loc), wlocname);
+                continue;
+            }
+        }
+        func(LocaleConstant(loc), wbasename);
+    }
+}
+
+static void MarkNpcBotDataDirty(uint32 entry, uint8 flags)
+{
+    std::lock_guard<std::mutex> lock(_botsDataDirtyLock);
+    _botsDataDirty[entry] |= flags;
+}
+
+static void AppendNpcBotDataFields(CharacterDatabaseTransaction trans, uint32 entry, NpcBotData const* botData, uint8 flags)
+{
+    CharacterDatabasePreparedStatement* bstmt;
+    if (flags & NPCBOT_DATA_DIRTY_ROLES)
+    {
+        bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_ROLES);
+        //"UPDATE character_npcbot SET roles = ? WHERE entry = ?", CONNECTION_ASYNC
+        bstmt->SetData(0, botData->roles);
+        bstmt->SetData(1, entry);
+        trans->Append(bstmt);
+    }
+    if (flags & NPCBOT_DATA_DIRTY_SPEC)
+    {
+        bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_SPEC);
+        //"UPDATE characters_npcbot SET spec = ? WHERE entry = ?", CONNECTION_ASYNCH
+        bstmt->SetData(0, botData->spec);
+        bstmt->SetData(1, entry);
+        trans->Append(bstmt);
+    }
+    if (flags & NPCBOT_DATA_DIRTY_FACTION)
+    {
+        bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_FACTION);
+        //"UPDATE characters_npcbot SET faction = ? WHERE entry = ?", CONNECTION_ASYNCH
+        bstmt->SetData(0, botData->faction);
+        bstmt->SetData(1, entry);
+        trans->Append(bstmt);
+    }
+    if (flags & NPCBOT_DATA_DIRTY_DISABLED_SPELLS)
+    {
+        std::ostringstream ss;
+        for (uint32 spellId : botData->disabled_spells)
+            ss << spellId << ' ';
+
+        bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_DISABLED_SPELLS);
+        //"UPDATE characters_npcbot SET spells_disabled = ? WHERE entry = ?", CONNECTION_ASYNCH
+        bstmt->SetData(0, ss.str());
+        bstmt->SetData(1, entry);
+        trans->Append(bstmt);
+    }
+}
+
 bool BotBankItemCompare::operator()(Item const* item1, Item const* item2) const
 {
     ItemTemplate const* proto1 = item1->GetTemplate();
@@ -259,10 +380,6 @@ private:
     {
         ASSERT(!spareBotIdsPerClass.empty());
 
-        CreatureTemplateContainer const* all_templates = sObjectMgr->GetCreatureTemplates();
-
-        while (all_templates->find(++next_bot_id) != all_templates->cend()) {}
-
         auto const& spareBotPair = Acore::Containers::SelectRandomContainerElement(spareBotIdsPerClass);
         const uint8 bot_class = spareBotPair.first;
         auto const& cSet = spareBotPair.second;
@@ -295,9 +412,16 @@ private:
                 level_nodes.push_back(node);
         }
 
-        ASSERT(!level_nodes.empty());
+        //can happen with zone restricted spawns, caller retries with another class
+        if (level_nodes.empty())
+            return false;
+
         WanderNode const* spawnLoc = Acore::Containers::SelectRandomContainerElement(level_nodes);
 
+        CreatureTemplateContainer const* all_templates = sObjectMgr->GetCreatureTemplates();
+
+        while (all_templates->find(++next_bot_id) != all_templates->cend()) {}
+
         CreatureTemplate& bot_template = _botsWanderCreatureTemplates[next_bot_id];
         //copy all fields
         bot_template = *orig_template;
@@ -588,6 +712,57 @@ public:
         return true;
     }
 
+    //Spawn nodes are limited to a single zone (population controller)
+    bool GenerateWanderingBotsForZone(uint32 zoneId, uint8 bracket, uint32 count, uint32& spawned)
+    {
+        if (_spareBotIdsPerClassMap.empty())
+            return false;
+
+        NodeVec spawns_a, spawns_h, spawns_n;
+        WanderNode::DoForAllZoneWPs(zoneId, [&spawns_a, &spawns_h, &spawns_n](WanderNode const* wp) {
+            if (!wp->HasFlag(BotWPFlags::BOTWP_FLAG_SPAWN))
+                return;
+            if (wp->HasFlag(BotWPFlags::BOTWP_FLAG_ALLIANCE_ONLY))
+                spawns_a.push_back(wp);
+            else if (wp->HasFlag(BotWPFlags::BOTWP_FLAG_HORDE_ONLY))
+                spawns_h.push_back(wp);
+            else
+            {
+                spawns_a.push_back(wp);
+                spawns_h.push_back(wp);
+                spawns_n.push_back(wp);
+            }
+        });
+
+        if (spawns_a.empty() && spawns_h.empty())
+            return false;
+
+        //make a full copy
+        decltype (_spareBotIdsPerClassMap) spareBotIdsPerClass = _spareBotIdsPerClassMap;
+        for (uint32 i = 0; i < count && !spareBotIdsPerClass.empty();)
+        {
+            //bot class, faction and level must fit one of zone's nodes
+            int8 tries = 10;
+            do {
+                --tries;
+                if (GenerateWanderingBotToSpawn(spareBotIdsPerClass, bracket, spawns_a, spawns_h, spawns_n, false, nullptr, nullptr))
+                {
+                    ++i;
+                    ++spawned;
+                    break;
+                }
+            } while (tries >= 0 && !spareBotIdsPerClass.empty());
+
+            if (tries < 0)
+                break;
+        }
+
+        if (spawned)
+            CharacterDatabase.Execute("UPDATE worldstates SET value = {} WHERE entry = {}", next_bot_id, uint32(BOT_GIVER_ENTRY));
+
+        return spawned == count;
+    }
+
     static WanderingBotsGenerator* instance()
     {
         static WanderingBotsGenerator _instance;
@@ -596,12 +771,143 @@ public:
 };
 #define sBotGen WanderingBotsGenerator::instance()
 
+//Moves continent wanderers towards zones with players: idle bots in zones without players are despawned
+//and replaced with new bots spawned at spawn nodes of populated zones, matching players' level bands
+//Total amount of wanderers never exceeds NpcBot.WanderingBots.Continents.Count
+static void UpdateWanderingBotsPopulation()
+{
+    struct ZonePopulation
+    {
+        std::vector<uint8> playerLevels;
+        std::vector<Creature const*> idleBots;
+        uint32 bots = 0;
+    };
+
+    std::unordered_map<uint32 /*zoneId*/, ZonePopulation> zones;
+    uint32 totalPlayers = 0;
+    for (auto const& kv : sWorld->GetAllSessions())
+    {
+        Player const* player = kv.second->GetPlayer();
+        if (!player || !player->IsInWorld() || player->IsGameMaster() || !player->GetMap()->GetEntry()->IsContinent())
+            continue;
+
+        zones[player->GetZoneId()].playerLevels.push_back(player->GetLevel());
+        ++totalPlayers;
+    }
+
+    if (!totalPlayers)
+        return;
+
+    uint32 wanderers = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(*BotDataMgr::GetLock());
+        for (Creature const* bot : _existingBots)
+        {
+            if (!bot->IsWandererBot() || !bot->IsInWorld() || !bot->GetMap()->GetEntry()->IsContinent())
+                continue;
+            if (_botsWanderCreaturesToDespawn.find(bot->GetEntry()) != _botsWanderCreaturesToDespawn.cend())
+                continue;
+
+            ++wanderers;
+            ZonePopulation& zone = zones[bot->GetZoneId()];
+            ++zone.bots;
+            if (zone.playerLevels.empty() && bot->IsAlive() && !bot->IsInCombat() && bot->GetBotAI()->canUpdate)
+                zone.idleBots.push_back(bot);
+        }
+    }
+    for (auto const& p : _botsWanderCreaturesToSpawn)
+    {
+        if (sMapStore.LookupEntry(p.second->GetMapId())->IsContinent())
+        {
+            ++wanderers;
+            ++zones[p.second->GetZoneId()].bots;
+        }
+    }
+
+    //zones with players get share of wanderers proportional to players count
+    const uint32 desired = BotMgr::GetDesiredWanderingBotsCount();
+    uint32 moves = BotMgr::GetWanderingBotsPopulationMaxMoves();
+    uint32 free_slots = desired > wanderers ? desired - wanderers : 0;
+    std::vector<Creature const*> recyclable;
+    for (auto& kv : zones)
+        recyclable.insert(recyclable.end(), kv.second.idleBots.cbegin(), kv.second.idleBots.cend());
+    Acore::Containers::RandomShuffle(recyclable);
+
+    uint32 despawned = 0;
+    uint32 spawned = 0;
+    for (auto const& kv : zones)
+    {
+        if (!moves)
+            break;
+
+        ZonePopulation const& zone = kv.second;
+        if (zone.playerLevels.empty())
+            continue;
+
+        //only zones bots can be spawned in
+        uint8 minLevel = DEFAULT_MAX_LEVEL;
+        uint8 maxLevel = 0;
+        WanderNode::DoForAllZoneWPs(kv.first, [&minLevel, &maxLevel](WanderNode const* wp) {
+            if (wp->HasFlag(BotWPFlags::BOTWP_FLAG_SPAWN))
+            {
+                minLevel = std::min<uint8>(minLevel, wp->GetLevels().first);
+                maxLevel = std::max<uint8>(maxLevel, wp->GetLevels().second);
+            }
+        });
+        if (minLevel > maxLevel)
+            continue;
+
+        uint32 target = std::max<uint32>(desired * zone.playerLevels.size() / totalPlayers, 1);
+        target = std::min<uint32>(target, uint32(zone.playerLevels.size()) * BOT_WANDERER_POPULATION_PER_PLAYER);
+        uint32 deficit = std::min<uint32>(target > zone.bots ? target - zone.bots : 0, moves);
+        if (!deficit)
+            continue;
+
+        //use free slots first, these are left by bots recycled on previous update (or borrowed by BGs)
+        uint32 to_spawn = std::min<uint32>(deficit, free_slots);
+        if (to_spawn)
+        {
+            uint8 level = std::clamp<uint8>(Acore::Containers::SelectRandomContainerElement(zone.playerLevels), minLevel, maxLevel);
+            uint32 zone_spawned = 0;
+            sBotGen->GenerateWanderingBotsForZone(kv.first, level / 10, to_spawn, zone_spawned);
+            free_slots -= zone_spawned;
+            spawned += zone_spawned;
+            moves -= zone_spawned;
+            deficit -= zone_spawned;
+            //zone has no nodes matching players, don't free up slots for it
+            if (zone_spawned < to_spawn)
+                continue;
+        }
+
+        //free up slots for next update, recycled bots are returned to spare bots on despawn
+        for (; deficit && moves && !recyclable.empty(); --deficit, --moves)
+        {
+            BotDataMgr::DespawnWandererBot(recyclable.back()->GetEntry());
+            recyclable.pop_back();
+            ++despawned;
+        }
+    }
+
+    if (spawned || despawned)
+        LOG_DEBUG("npcbots", "Wanderers population: {} players, {} wanderers ({} desired), {} spawned, {} recycled",
+            totalPlayers, wanderers, desired, spawned, despawned);
+}
+
 void BotDataMgr::Update(uint32 diff)
 {
     botSpawnEvents.Update(diff);
     for (auto& kv : botBGJoinEvents)
         kv.second.Update(diff);
 
+    static const uint32 NPCBOT_DATA_SAVE_DELAY = 5000;
+
+    next_bot_data_save_delay += diff;
+    if (next_bot_data_save_delay >= NPCBOT_DATA_SAVE_DELAY)
+    {
+        next_bot_data_save_delay = 0;
+        SaveNpcBotData();
+    }
+
     if (!_botsWanderCreaturesToDespawn.empty())
     {
         LOG_DEBUG("npcbots", "Bots to despawn: {}", uint32(_botsWanderCreaturesToDespawn.size()));
@@ -655,26 +961,57 @@ void BotDataMgr::Update(uint32 diff)
         }
     }
 
+    if (const uint32 populationInterval = BotMgr::GetWanderingBotsPopulationUpdateInterval())
+    {
+        next_wandering_bot_population_update_delay += diff;
+        if (next_wandering_bot_population_update_delay >= populationInterval && allBotsLoaded)
+        {
+            next_wandering_bot_population_update_delay = 0;
+            UpdateWanderingBotsPopulation();
+        }
+    }
+
     if (!_botsWanderCreaturesToSpawn.empty())
     {
-        static const uint32 WANDERING_BOT_SPAWN_DELAY = 500;
+        const uint32 spawnDelay = BotMgr::GetWanderingBotsSpawnDelay();
+        const uint32 batchSize = BotMgr::GetWanderingBotsSpawnBatchSize();
+        const uint32 timeBudget = BotMgr::GetWanderingBotsSpawnTimeBudget();
 
         next_wandering_bot_spawn_delay += diff;
+        if (next_wandering_bot_spawn_delay < spawnDelay)
+            return;
+        next_wandering_bot_spawn_delay = 0;
 
-        while (next_wandering_bot_spawn_delay >= WANDERING_BOT_SPAWN_DELAY && !_botsWanderCreaturesToSpawn.empty())
+        //spawn a batch per tick, but stop early if the tick budget is exceeded, leftovers go into the next batch
+        uint32 batchMSTime = getMSTime();
+        for (uint32 i = 0; i < batchSize && !_botsWanderCreaturesToSpawn.empty(); ++i)
         {
-            next_wandering_bot_spawn_delay -= WANDERING_BOT_SPAWN_DELAY;
-
-            auto const& p = _botsWanderCreaturesToSpawn.front();
+            //keep batches map-local: grid for the node is likely loaded already by the previous spawn
+            auto itr = _botsWanderCreaturesToSpawn.begin();
+            if (i > 0)
+            {
+                uint32 lastMapId = _lastSpawnedWandererMapId;
+                auto mitr = std::find_if(_botsWanderCreaturesToSpawn.begin(), _botsWanderCreaturesToSpawn.end(), [lastMapId](auto const& p) {
+                    return p.second->GetMapId() == lastMapId;
+                });
+                if (mitr != _botsWanderCreaturesToSpawn.end())
+                    itr = mitr;
+            }
 
-            uint32 bot_id = p.first;
-            WanderNode const* spawnLoc = p.second;
+            uint32 bot_id = itr->first;
+            WanderNode const* spawnLoc = itr->second;
 
-            _botsWanderCreaturesToSpawn.pop_front();
+            _botsWanderCreaturesToSpawn.erase(itr);
+            _lastSpawnedWandererMapId = spawnLoc->GetMapId();
 
             SpawnWandererBot(bot_id, spawnLoc, nullptr);
+
+            if (timeBudget && GetMSTimeDiffToNow(batchMSTime) >= timeBudget)
+                break;
         }
 
+        LOG_DEBUG("npcbots", "Wanderer spawn batch done in {} ms, {} bots left to spawn", GetMSTimeDiffToNow(batchMSTime), uint32(_botsWanderCreaturesToSpawn.size()));
+
         return;
     }
 }
@@ -809,7 +1146,6 @@ void BotDataMgr::LoadNpcBots(bool spawn)
         uint32 botcounter = 0;
         uint32 datacounter = 0;
         std::set<uint32> botgrids;
-        QueryResult infores;
         CreatureTemplate const* proto;
         NpcBotData* botData;
         std::list<uint32> entryList;
@@ -846,6 +1182,7 @@ void BotDataMgr::LoadNpcBots(bool spawn)
 
             entryList.push_back(entry);
             _botsData[entry] = botData;
+            IndexBotOwner(entry, 0, botData->owner);
             ++datacounter;
 
         } while (result->NextRow());
@@ -854,25 +1191,36 @@ void BotDataMgr::LoadNpcBots(bool spawn)
 
         if (spawn)
         {
+            //`creature` table is already loaded by ObjectMgr, join bot entries with their spawns in memory
+            //instead of querying spawn for every bot (lowest spawnId is used if bot has more than one)
+            std::unordered_map<uint32 /*entry*/, std::pair<ObjectGuid::LowType, CreatureData const*>> botSpawns;
+            botSpawns.reserve(_botsData.size());
+            for (CreatureDataContainer::value_type const& p : sObjectMgr->GetAllCreatureData())
+            {
+                if (_botsData.find(p.second.id1) == _botsData.end())
+                    continue;
+
+                auto [sitr, inserted] = botSpawns.try_emplace(p.second.id1, p.first, &p.second);
+                if (!inserted && p.first < sitr->second.first)
+                    sitr->second = { p.first, &p.second };
+            }
+
             for (std::list<uint32>::const_iterator itr = entryList.cbegin(); itr != entryList.cend(); ++itr)
             {
                 uint32 entry = *itr;
                 proto = sObjectMgr->GetCreatureTemplate(entry);
-                //                                     1     2    3           4            5           6
-                infores = WorldDatabase.Query("SELECT guid, map, position_x, position_y"/*, position_z, orientation*/" FROM creature WHERE id1 = {}", entry);
-                if (!infores)
+                auto sitr = botSpawns.find(entry);
+                if (sitr == botSpawns.end())
                 {
                     LOG_ERROR("server.loading", "Cannot spawn npcbot {} (id: {}), not found in `creature` table!", proto->Name.c_str(), entry);
                     continue;
                 }
 
-                field = infores->Fetch();
-                uint32 tableGuid = field[0].Get<uint32>();
-                uint32 mapId = uint32(field[1].Get<uint16>());
-                float pos_x = field[2].Get<float>();
-                float pos_y = field[3].Get<float>();
-                //float pos_z = field[4].GetFloat();
-                //float ori = field[5].GetFloat();
+                CreatureData const* spawnData = sitr->second.second;
+                uint32 tableGuid = sitr->second.first;
+                uint32 mapId = uint32(spawnData->mapid);
+                float pos_x = spawnData->posX;
+                float pos_y = spawnData->posY;
 
                 CellCoord c = Acore::ComputeCellCoord(pos_x, pos_y);
                 GridCoord g = Acore::ComputeGridCoord(pos_x, pos_y);
@@ -1562,7 +1910,10 @@ void BotDataMgr::CreateWanderingBotsSortedGear()
                 (itt.InventoryType == INVTYPE_FINGER || itt.InventoryType == INVTYPE_TRINKET || itt.InventoryType == INVTYPE_CLOAK || itt.InventoryType == INVTYPE_NECK || itt.InventoryType == INVTYPE_SHIELD))
                 continue;
             if (!itt.AllowableClass || itt.AllowableClass >= ((1u << MAX_CLASSES) - 1) || !!(itt.AllowableClass & (1 << (c - 1))))
+            {
                 _botsWanderCreaturesSortedGear[c][slot][lstep].push_back(itt.ItemId);
+                _botsWanderCreaturesSortedGearTemplates[c][slot][lstep].push_back(&itt);
+            }
         }
     };
 
@@ -2005,35 +2356,32 @@ Item* BotDataMgr::GenerateWanderingBotItem(uint8 slot, uint8 botclass, uint8 lev
     ASSERT(level <= DEFAULT_MAX_LEVEL + 4);
 
     uint8 lvl = level;
-    ItemIdVector const* itemIdVec = &_botsWanderCreaturesSortedGear[botclass][slot][lvl / ITEM_SORTING_LEVEL_STEP];
+    ItemTemplateVector const* protoVec = &_botsWanderCreaturesSortedGearTemplates[botclass][slot][lvl / ITEM_SORTING_LEVEL_STEP];
 
-    while (itemIdVec->empty() && lvl > ITEM_SORTING_LEVEL_STEP)
+    while (protoVec->empty() && lvl > ITEM_SORTING_LEVEL_STEP)
     {
         lvl -= ITEM_SORTING_LEVEL_STEP;
-        itemIdVec = &_botsWanderCreaturesSortedGear[botclass][slot][lvl / ITEM_SORTING_LEVEL_STEP];
+        protoVec = &_botsWanderCreaturesSortedGearTemplates[botclass][slot][lvl / ITEM_SORTING_LEVEL_STEP];
     }
 
-    if (!itemIdVec->empty())
+    //single pass reservoir pick: uniform among items passing the check, no temporary container
+    ItemTemplate const* selected = nullptr;
+    uint32 valid_count = 0;
+    for (ItemTemplate const* proto : *protoVec)
     {
-        ItemIdVector validVec;
-        validVec.reserve(itemIdVec->size());
-        for (uint32 iid : *itemIdVec)
-        {
-            ItemTemplate const* proto = sObjectMgr->GetItemTemplate(iid);
-            if (check(proto))
-                validVec.push_back(iid);
-        }
+        if (check(proto) && urand(0, valid_count++) == 0)
+            selected = proto;
+    }
 
-        if (!validVec.empty())
+    if (selected)
+    {
+        uint32 itemId = selected->ItemId;
+        if (Item* newItem = Item::CreateItem(itemId, 1, nullptr))
         {
-            uint32 itemId = Acore::Containers::SelectRandomContainerElement(validVec);
-            if (Item* newItem = Item::CreateItem(itemId, 1, nullptr))
-            {
-                if (uint32 randomPropertyId = Item::GenerateItemRandomPropertyId(itemId))
-                    newItem->SetItemRandomProperties(randomPropertyId);
+            if (uint32 randomPropertyId = Item::GenerateItemRandomPropertyId(itemId))
+                newItem->SetItemRandomProperties(randomPropertyId);
 
-                return newItem;
-            }
+            return newItem;
         }
     }
 
@@ -2307,6 +2655,10 @@ void BotDataMgr::UpdateNpcBotData(uint32 entry, NpcBotDataUpdateType updateType,
         case NPCBOT_UPDATE_OWNER:
             if (itr->second->owner == *(uint32*)(data))
                 break;
+            {
+                std::unique_lock<std::shared_mutex> lock(*GetLock());
+                IndexBotOwner(entry, itr->second->owner, *(uint32*)(data));
+            }
             itr->second->owner = *(uint32*)(data);
             bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_OWNER);
             //"UPDATE characters_npcbot SET owner = ? WHERE entry = ?", CONNECTION_ASYNC
@@ -2323,40 +2675,22 @@ void BotDataMgr::UpdateNpcBotData(uint32 entry, NpcBotDataUpdateType updateType,
             break;
         case NPCBOT_UPDATE_ROLES:
             itr->second->roles = *(uint32*)(data);
-            bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_ROLES);
-            //"UPDATE character_npcbot SET roles = ? WHERE entry = ?", CONNECTION_ASYNC
-            bstmt->SetData(0, itr->second->roles);
-            bstmt->SetData(1, entry);
-            CharacterDatabase.Execute(bstmt);
+            MarkNpcBotDataDirty(entry, NPCBOT_DATA_DIRTY_ROLES);
             break;
         case NPCBOT_UPDATE_SPEC:
             itr->second->spec = *(uint8*)(data);
-            bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_SPEC);
-            //"UPDATE characters_npcbot SET spec = ? WHERE entry = ?", CONNECTION_ASYNCH
-            bstmt->SetData(0, itr->second->spec);
-            bstmt->SetData(1, entry);
-            CharacterDatabase.Execute(bstmt);
+            MarkNpcBotDataDirty(entry, NPCBOT_DATA_DIRTY_SPEC);
             break;
         case NPCBOT_UPDATE_FACTION:
             itr->second->faction = *(uint32*)(data);
-            bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_FACTION);
-            //"UPDATE characters_npcbot SET faction = ? WHERE entry = ?", CONNECTION_ASYNCH
-            bstmt->SetData(0, itr->second->faction);
-            bstmt->SetData(1, entry);
-            CharacterDatabase.Execute(bstmt);
+            MarkNpcBotDataDirty(entry, NPCBOT_DATA_DIRTY_FACTION);
             break;
         case NPCBOT_UPDATE_DISABLED_SPELLS:
         {
             NpcBotData::DisabledSpellsContainer const* spells = (NpcBotData::DisabledSpellsContainer const*)(data);
-            std::ostringstream ss;
-            for (NpcBotData::DisabledSpellsContainer::const_iterator citr = spells->begin(); citr != spells->end(); ++citr)
-                ss << (*citr) << ' ';
-
-            bstmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_NPCBOT_DISABLED_SPELLS);
-            //"UPDATE characters_npcbot SET spells_disabled = ? WHERE entry = ?", CONNECTION_ASYNCH
-            bstmt->SetData(0, ss.str());
-            bstmt->SetData(1, entry);
-            CharacterDatabase.Execute(bstmt);
+            if (spells != &itr->second->disabled_spells)
+                itr->second->disabled_spells = *spells;
+            MarkNpcBotDataDirty(entry, NPCBOT_DATA_DIRTY_DISABLED_SPELLS);
             break;
         }
         case NPCBOT_UPDATE_EQUIPS:
@@ -2443,6 +2777,15 @@ void BotDataMgr::UpdateNpcBotData(uint32 entry, NpcBotDataUpdateType updateType,
         {
             NpcBotDataMap::iterator bitr = _botsData.find(entry);
             ASSERT(bitr != _botsData.end());
+            {
+                std::unique_lock<std::shared_mutex> lock(*GetLock());
+                IndexBotOwner(entry, bitr->second->owner, 0);
+            }
+            {
+                //row is deleted, pending changes are meaningless
+                std::lock_guard<std::mutex> dlock(_botsDataDirtyLock);
+                _botsDataDirty.erase(entry);
+            }
             delete bitr->second;
             _botsData.erase(bitr);
             bstmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_NPCBOT);
@@ -2484,6 +2827,44 @@ void BotDataMgr::UpdateNpcBotDataAll(uint32 playerGuid, NpcBotDataUpdateType upd
     }
 }
 
+void BotDataMgr::SaveNpcBotData(Optional<uint32> ownerGuid)
+{
+    decltype(_botsDataDirty) dirty;
+    {
+        std::lock_guard<std::mutex> lock(_botsDataDirtyLock);
+        if (_botsDataDirty.empty())
+            return;
+
+        if (ownerGuid == std::nullopt)
+            dirty.swap(_botsDataDirty);
+        else
+        {
+            for (auto itr = _botsDataDirty.begin(); itr != _botsDataDirty.end();)
+            {
+                NpcBotDataMap::const_iterator bitr = _botsData.find(itr->first);
+                if (bitr != _botsData.cend() && bitr->second->owner != *ownerGuid)
+                {
+                    ++itr;
+                    continue;
+                }
+                dirty.insert(*itr);
+                itr = _botsDataDirty.erase(itr);
+            }
+        }
+    }
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    for (auto const& [entry, flags] : dirty)
+    {
+        NpcBotDataMap::const_iterator bitr = _botsData.find(entry);
+        if (bitr != _botsData.cend())
+            AppendNpcBotDataFields(trans, entry, bitr->second, flags);
+    }
+    CharacterDatabase.CommitTransaction(trans);
+
+    LOG_DEBUG("npcbots", "Saved npcbot data for {} bots", uint32(dirty.size()));
+}
+
 void BotDataMgr::SaveNpcBotStats(NpcBotStats const* stats)
 {
     CharacterDatabasePreparedStatement* bstmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_NPCBOT_STATS);
@@ -2607,6 +2988,10 @@ void BotDataMgr::RegisterBot(Creature const* bot)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     _existingBots.insert(bot);
+    _existingBotsByEntry[bot->GetEntry()] = bot;
+    DoForBotNamePerLocale(bot, [bot](LocaleConstant loc, std::wstring const& wname) {
+        _existingBotsByName[loc][wname].push_back(bot);
+    });
     //TC_LOG_ERROR("entities.unit", "BotDataMgr::RegisterBot: registered bot %u (%s)", bot->GetEntry(), bot->GetName().c_str());
 }
 void BotDataMgr::UnregisterBot(Creature const* bot)
@@ -2621,45 +3006,46 @@ void BotDataMgr::UnregisterBot(Creature const* bot)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     _existingBots.erase(bot);
+    auto eitr = _existingBotsByEntry.find(bot->GetEntry());
+    if (eitr != _existingBotsByEntry.end() && eitr->second == bot)
+        _existingBotsByEntry.erase(eitr);
+    DoForBotNamePerLocale(bot, [bot](LocaleConstant loc, std::wstring const& wname) {
+        auto nitr = _existingBotsByName[loc].find(wname);
+        if (nitr == _existingBotsByName[loc].end())
+            return;
+        nitr->second.erase(std::remove(nitr->second.begin(), nitr->second.end(), bot), nitr->second.end());
+        if (nitr->second.empty())
+            _existingBotsByName[loc].erase(nitr);
+    });
     //TC_LOG_ERROR("entities.unit", "BotDataMgr::UnregisterBot: unregistered bot %u (%s)", bot->GetEntry(), bot->GetName().c_str());
 }
 Creature const* BotDataMgr::FindBot(uint32 entry)
 {
     std::shared_lock<std::shared_mutex> lock(*GetLock());
 
-    for (NpcBotRegistry::const_iterator ci = _existingBots.cbegin(); ci != _existingBots.cend(); ++ci)
-    {
-        if ((*ci)->GetEntry() == entry)
-            return *ci;
-    }
-    return nullptr;
+    auto itr = _existingBotsByEntry.find(entry);
+    return itr != _existingBotsByEntry.cend() ? itr->second : nullptr;
 }
 Creature const* BotDataMgr::FindBot(std::string_view name, LocaleConstant loc, std::vector<uint32> const* not_ids)
 {
+    if (loc >= TOTAL_LOCALES)
+        loc = LOCALE_enUS;
+
     std::wstring wname;
     if (Utf8toWStr(name, wname))
     {
         wstrToLower(wname);
         std::shared_lock<std::shared_mutex> lock(*GetLock());
-        for (NpcBotRegistry::const_iterator ci = _existingBots.cbegin(); ci != _existingBots.cend(); ++ci)
-        {
-            if (not_ids && std::find(not_ids->cbegin(), not_ids->cend(), (*ci)->GetEntry()) != not_ids->cend())
-                continue;
-
-            std::string basename = (*ci)->GetName();
-            if (CreatureLocale const* creatureInfo = sObjectMgr->GetCreatureLocale((*ci)->GetEntry()))
-            {
-                if (creatureInfo->Name.size() > loc && !creatureInfo->Name[loc].empty())
-                    basename = creatureInfo->Name[loc];
-            }
+        auto itr = _existingBotsByName[loc].find(wname);
+        if (itr == _existingBotsByName[loc].cend())
+            return nullptr;
 
-            std::wstring wbname;
-            if (!Utf8toWStr(basename, wbname))
+        for (Creature const* bot : itr->second)
+        {
+            if (not_ids && std::find(not_ids->cbegin(), not_ids->cend(), bot->GetEntry()) != not_ids->cend())
                 continue;
 
-            wstrToLower(wbname);
-            if (wbname == wname)
-                return *ci;
+            return bot;
         }
     }
 
@@ -2677,10 +3063,15 @@ void BotDataMgr::GetNPCBotGuidsByOwner(std::vector<ObjectGuid> &guids_vec, Objec
 
     std::shared_lock<std::shared_mutex> lock(*GetLock());
 
-    for (NpcBotRegistry::const_iterator ci = _existingBots.cbegin(); ci != _existingBots.cend(); ++ci)
+    auto oitr = _botEntriesByOwner.find(owner_guid.GetCounter());
+    if (oitr == _botEntriesByOwner.cend())
+        return;
+
+    for (uint32 entry : oitr->second)
     {
-        if (_botsData[(*ci)->GetEntry()]->owner == owner_guid.GetCounter())
-            guids_vec.push_back((*ci)->GetGUID());
+        auto eitr = _existingBotsByEntry.find(entry);
+        if (eitr != _existingBotsByEntry.cend())
+            guids_vec.push_back(eitr->second->GetGUID());
     }
 }
 
@@ -2690,13 +3081,8 @@ ObjectGuid BotDataMgr::GetNPCBotGuid(uint32 entry)
 
     std::shared_lock<std::shared_mutex> lock(*GetLock());
 
-    for (NpcBotRegistry::const_iterator ci = _existingBots.cbegin(); ci != _existingBots.cend(); ++ci)
-    {
-        if ((*ci)->GetEntry() == entry)
-            return (*ci)->GetGUID();
-    }
-
-    return ObjectGuid::Empty;
+    auto itr = _existingBotsByEntry.find(entry);
+    return itr != _existingBotsByEntry.cend() ? itr->second->GetGUID() : ObjectGuid::Empty;
 }
 
 std::vector<uint32> BotDataMgr::GetExistingNPCBotIds()
@@ -2714,8 +3100,13 @@ std::vector<uint32> BotDataMgr::GetExistingNPCBotIds()
 uint8 BotDataMgr::GetOwnedBotsCount(ObjectGuid owner_guid, uint32 class_mask)
 {
     uint8 count = 0;
-    for (decltype(_botsData)::value_type const& bdata : _botsData)
-        if (bdata.second->owner == owner_guid.GetCounter() && (!class_mask || !!(class_mask & (1u << (_botsExtras[bdata.first]->bclass - 1)))))
+    std::shared_lock<std::shared_mutex> lock(*GetLock());
+    auto oitr = _botEntriesByOwner.find(owner_guid.GetCounter());
+    if (oitr == _botEntriesByOwner.cend())
+        return count;
+
+    for (uint32 entry : oitr->second)
+        if (!class_mask || !!(class_mask & (1u << (_botsExtras[entry]->bclass - 1))))
             ++count;
 
     return count;
@@ -2847,7 +3238,7 @@ uint32 BotDataMgr::GetTeamForFaction(uint32 factionTemplateId)
     }
 }
 
-bool BotDataMgr::IsWanderNodeAvailableForBotFaction(WanderNode const* wp, uint32 factionTemplateId, bool teleport)
+static bool IsWanderNodeAvailableForTeam(WanderNode const* wp, TeamId teamId, bool teleport)
 {
     if (!teleport)
     {
@@ -2861,7 +3252,7 @@ bool BotDataMgr::IsWanderNodeAvailableForBotFaction(WanderNode const* wp, uint32
             return false;
     }
 
-    switch (GetTeamIdForFaction(factionTemplateId))
+    switch (teamId)
     {
         case TEAM_ALLIANCE:
             return !wp->HasFlag(BotWPFlags::BOTWP_FLAG_HORDE_ONLY);
@@ -2874,6 +3265,50 @@ bool BotDataMgr::IsWanderNodeAvailableForBotFaction(WanderNode const* wp, uint32
     }
 }
 
+bool BotDataMgr::IsWanderNodeAvailableForBotFaction(WanderNode const* wp, uint32 factionTemplateId, bool teleport)
+{
+    return IsWanderNodeAvailableForTeam(wp, GetTeamIdForFaction(factionTemplateId), teleport);
+}
+
+//Must be called with WanderNode lock held
+static WanderNodeVec const& GetWanderSpawnNodesForTeamLevel(TeamId teamId, uint8 lvl)
+{
+    static WanderNodeVec const emptyNodes;
+
+    uint32 generation = WanderNode::GetWPsGeneration();
+    if (!_botsWanderSpawnNodesBuilt || _botsWanderSpawnNodesGeneration != generation)
+    {
+        for (std::vector<WanderNodeVec>& levelNodes : _botsWanderSpawnNodesPerTeamLevel)
+            levelNodes.clear();
+
+        WanderNode::DoForAllWPs([](WanderNode const* wp) {
+            if (!wp->HasFlag(BotWPFlags::BOTWP_FLAG_SPAWN))
+                return;
+
+            uint8 minLevel = wp->GetLevels().first;
+            uint8 maxLevel = wp->GetLevels().second;
+            for (uint8 tId = TEAM_ALLIANCE; tId <= TEAM_NEUTRAL; ++tId)
+            {
+                if (!IsWanderNodeAvailableForTeam(wp, TeamId(tId), true))
+                    continue;
+
+                std::vector<WanderNodeVec>& levelNodes = _botsWanderSpawnNodesPerTeamLevel[tId];
+                if (levelNodes.size() <= maxLevel)
+                    levelNodes.resize(maxLevel + 1u);
+                //same as node_viable: lvl + 2 >= min && lvl <= max
+                for (uint32 l = std::max<int32>(int32(minLevel) - 2, 0); l <= maxLevel; ++l)
+                    levelNodes[l].push_back(wp);
+            }
+        });
+
+        _botsWanderSpawnNodesGeneration = generation;
+        _botsWanderSpawnNodesBuilt = true;
+    }
+
+    std::vector<WanderNodeVec> const& levelNodes = _botsWanderSpawnNodesPerTeamLevel[teamId];
+    return lvl < levelNodes.size() ? levelNodes[lvl] : emptyNodes;
+}
+
 WanderNode const* BotDataMgr::GetNextWanderNode(WanderNode const* curNode, WanderNode const* lastNode, Position const* fromPos, Creature const* bot, uint8 lvl, bool random)
 {
     using NodeList = std::list<WanderNode const*>;
@@ -2890,9 +3325,8 @@ WanderNode const* BotDataMgr::GetNextWanderNode(WanderNode const* curNode, Wande
     {
         if (bot->IsInWorld() && !bot->GetMap()->IsBattlegroundOrArena())
         {
-            WanderNode::DoForAllMapWPs(curNode->GetMapId(), [&links, lvl = lvl, fac = faction, pos = fromPos](WanderNode const* wp) {
-                if (pos->GetExactDist2d(wp) < MAX_WANDER_NODE_DISTANCE &&
-                    IsWanderNodeAvailableForBotFaction(wp, fac, true) && node_viable(wp, lvl))
+            WanderNode::DoForAllMapWPsInRange(curNode->GetMapId(), fromPos, MAX_WANDER_NODE_DISTANCE, [&links, lvl = lvl, fac = faction](WanderNode const* wp) {
+                if (IsWanderNodeAvailableForBotFaction(wp, fac, true) && node_viable(wp, lvl))
                     links.push_back(wp);
             });
             if (!links.empty())
@@ -2900,51 +3334,22 @@ WanderNode const* BotDataMgr::GetNextWanderNode(WanderNode const* curNode, Wande
         }
 
         //Select closest
-        WanderNode const* node_new = nullptr;
-        float mindist = 50000.0f; // Anywhere
-        WanderNode::DoForAllMapWPs(curNode->GetMapId(), [&node_new, &mindist, lvl = lvl, fac = faction, pos = fromPos](WanderNode const* wp) {
-            float dist = pos->GetExactDist2d(wp);
-            if (dist < mindist &&
-                IsWanderNodeAvailableForBotFaction(wp, fac, false) && node_viable(wp, lvl))
-            {
-                mindist = dist;
-                node_new = wp;
-            }
+        return WanderNode::FindClosestMapWP(curNode->GetMapId(), fromPos, [lvl = lvl, fac = faction](WanderNode const* wp) {
+            return IsWanderNodeAvailableForBotFaction(wp, fac, false) && node_viable(wp, lvl);
         });
-        return node_new;
     }
 
     if (bot_ai::IsFlagCarrier(bot))
     {
-        NodeList flagDropNodes;
-        TeamId teamId = GetTeamIdForFaction(faction);
-        static const auto is_my_flag_drop_node = [](WanderNode const* dwp, TeamId tId) {
-            if (dwp->HasFlag(BotWPFlags::BOTWP_FLAG_BG_FLAG_DELIVER_TARGET))
-            {
-                //must only select own faction drop node
-                return (!dwp->HasFlag(BotWPFlags::BOTWP_FLAG_ALLIANCE_OR_HORDE_ONLY) ||
-                    (tId == TEAM_ALLIANCE && dwp->HasFlag(BotWPFlags::BOTWP_FLAG_ALLIANCE_ONLY)) ||
-                    (tId == TEAM_HORDE && dwp->HasFlag(BotWPFlags::BOTWP_FLAG_HORDE_ONLY)));
-            }
-            return false;
-        };
-        //check two levels of links, enough for: WSG
-        for (WanderNode const* dwp : curNode->GetLinks())
+        //must only select own faction drop node, routed over the whole node graph
+        BotWPRouteTarget routeTarget;
+        switch (GetTeamIdForFaction(faction))
         {
-            if (is_my_flag_drop_node(dwp, teamId))
-                flagDropNodes.push_back(dwp);
-            else
-            {
-                for (WanderNode const* dwpl : dwp->GetLinks())
-                {
-                    if (dwpl != curNode && is_my_flag_drop_node(dwpl, teamId))
-                    {
-                        flagDropNodes.push_back(dwp);
-                        break;
-                    }
-                }
-            }
+            case TEAM_ALLIANCE: routeTarget = BotWPRouteTarget::BOTWP_ROUTE_FLAG_DELIVER_ALLIANCE;  break;
+            case TEAM_HORDE:    routeTarget = BotWPRouteTarget::BOTWP_ROUTE_FLAG_DELIVER_HORDE;     break;
+            default:            routeTarget = BotWPRouteTarget::BOTWP_ROUTE_FLAG_DELIVER_NEUTRAL;   break;
         }
+        NodeList flagDropNodes = curNode->GetShortestPathLinks(routeTarget, NodeList(curNode->GetLinks().cbegin(), curNode->GetLinks().cend()));
         if (!flagDropNodes.empty())
             return flagDropNodes.size() == 1u ? flagDropNodes.front() : Acore::Containers::SelectRandomContainerElement(flagDropNodes);
     }
@@ -2960,10 +3365,15 @@ WanderNode const* BotDataMgr::GetNextWanderNode(WanderNode const* curNode, Wande
     //Overleveled or died: no viable nodes in reach, find one for teleport
     if (links.empty())
     {
-        WanderNode::DoForAllWPs([&links, lvl = lvl, fac = faction](WanderNode const* wp) {
-            if (IsWanderNodeAvailableForBotFaction(wp, fac, true) && wp->HasFlag(BotWPFlags::BOTWP_FLAG_SPAWN) && node_viable(wp, lvl))
-                links.push_back(wp);
-        });
+        std::unique_lock lock(*WanderNode::GetLock());
+        WanderNodeVec const& spawnNodes = GetWanderSpawnNodesForTeamLevel(GetTeamIdForFaction(faction), lvl);
+        if (spawnNodes.empty())
+        {
+            LOG_ERROR("npcbots", "GetNextWanderNode: no spawn nodes for bot {} ({}) faction {} level {}, check wander nodes data!",
+                bot->GetName(), bot->GetEntry(), faction, uint32(lvl));
+            return nullptr;
+        }
+        return spawnNodes.size() == 1u ? spawnNodes.front() : Acore::Containers::SelectRandomContainerElement(spawnNodes);
     }
 
     ASSERT(!links.empty());
@@ -2972,18 +3382,7 @@ WanderNode const* BotDataMgr::GetNextWanderNode(WanderNode const* curNode, Wande
 
 WanderNode const* BotDataMgr::GetClosestWanderNode(WorldLocation const* loc)
 {
-    float mindist = 50000.0f;
-    WanderNode const* closestNode = nullptr;
-    WanderNode::DoForAllMapWPs(loc->GetMapId(), [&mindist, &closestNode, loc = loc](WanderNode const* wp) {
-        float dist = wp->GetExactDist2d(loc);
-        if (dist < mindist)
-        {
-            mindist = dist;
-            closestNode = wp;
-        }
-    });
-
-    return closestNode;
+    return WanderNode::FindClosestMapWP(loc->GetMapId(), loc, [](WanderNode const*) { return true; });
 }
 
 BotBankItemContainer const* BotDataMgr::GetBotBankItems(ObjectGuid playerGuid)
@@ -3055,6 +3454,7 @@ public:
 
     void OnShutdown() override
     {
+        BotDataMgr::SaveNpcBotData();
         botSpawnEvents.KillAllEvents(true);
         for (auto& kv : botBGJoinEvents)
             kv.second.KillAllEvents(true);
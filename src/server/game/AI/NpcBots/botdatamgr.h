@@ -4,6 +4,7 @@
 #include "botcommon.h"
 #include "DatabaseEnvFwd.h"
 #include "DBCEnums.h"
+#include "Optional.h"
 
 #include <functional>
 #include <set>
@@ -168,6 +169,8 @@ class BotDataMgr
         static NpcBotData const* SelectNpcBotData(uint32 entry);
         static void UpdateNpcBotData(uint32 entry, NpcBotDataUpdateType updateType, void* data = nullptr);
         static void UpdateNpcBotDataAll(uint32 playerGuid, NpcBotDataUpdateType updateType, void* data = nullptr);
+        //Saves pending roles/spec/faction/disabled spells changes for all bots or bots of given owner
+        static void SaveNpcBotData(Optional<uint32> ownerGuid = {});
         static void SaveNpcBotStats(NpcBotStats const* stats);
 
         static NpcBotAppearanceData const* SelectNpcBotAppearance(uint32 entry);
@@ -0,0 +1,230 @@
+#include "bot_ai.h"
+#include "botcommon.h"
+#include "botdecision.h"
+#include "botmgr.h"
+#include "GameTime.h"
+#include "Log.h"
+#include "Map.h"
+#include "PCQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/*
+Name: botdecision
+%Complete: 100
+Comment: Parallel read-only decide phase for NPCBot updates within a map update
+*/
+
+#ifdef _MSC_VER
+# pragma warning(push, 4)
+#endif
+
+namespace
+{
+
+//One map's decide phase, shared between map thread and helping workers
+struct BotDecisionJob
+{
+    std::vector<bot_ai const*> bots;
+    uint32 diff = 0;
+    std::atomic<std::size_t> next{0};
+    uint32 helpers = 0;
+    std::mutex lock;
+    std::condition_variable done;
+
+    void Run()
+    {
+        for (std::size_t i = next++; i < bots.size(); i = next++)
+            bots[i]->PrepareUpdate(diff);
+    }
+
+    void OnHelperFinished()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        --helpers;
+        done.notify_all();
+    }
+
+    void WaitForHelpers()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while (helpers > 0)
+            done.wait(guard);
+    }
+};
+
+//not a pointer so queue never tries to delete jobs, they are owned by map threads
+struct BotDecisionTask
+{
+    BotDecisionJob* job = nullptr;
+};
+
+class BotDecisionWorkers
+{
+    public:
+        explicit BotDecisionWorkers(uint32 count)
+        {
+            _threads.reserve(count);
+            for (uint32 i = 0; i != count; ++i)
+                _threads.emplace_back(&BotDecisionWorkers::WorkerThread, this);
+        }
+
+        ~BotDecisionWorkers()
+        {
+            _queue.Cancel();
+            for (std::thread& thread : _threads)
+                if (thread.joinable())
+                    thread.join();
+        }
+
+        uint32 GetCount() const { return uint32(_threads.size()); }
+
+        void Push(BotDecisionJob* job) { _queue.Push(BotDecisionTask{ job }); }
+
+    private:
+        void WorkerThread()
+        {
+            while (true)
+            {
+                BotDecisionTask task;
+                _queue.WaitAndPop(task);
+                if (!task.job)
+                    return;
+
+                task.job->Run();
+                task.job->OnHelperFinished();
+            }
+        }
+
+        ProducerConsumerQueue<BotDecisionTask> _queue;
+        std::vector<std::thread> _threads;
+
+        BotDecisionWorkers(BotDecisionWorkers const&);
+};
+
+BotDecisionWorkers* GetWorkers()
+{
+    //thread count is only read once, changing it requires restart
+    static BotDecisionWorkers workers(BotMgr::GetBotDecisionThreads());
+    return &workers;
+}
+
+struct BotMapDecision
+{
+    Milliseconds tick = Milliseconds::zero();
+    //bots seen updating during current tick, decided on next tick
+    std::vector<ObjectGuid> seen;
+    std::vector<ObjectGuid> bots;
+    BotDecisionJob job;
+};
+
+//Erased when map is destroyed. Container has its own lock, entry is only used by map thread:
+//decide phase is skipped while continent regions are updated (see botcommon.h)
+std::unordered_map<uint64 /*mapId | instanceId*/, BotMapDecision> _mapDecisions;
+std::mutex _mapDecisionsLock;
+//bumped on erase so thread caches never hand out an erased decision
+std::atomic<uint32> _mapDecisionsGeneration{0};
+
+struct BotDecisionCache
+{
+    Map const* map = nullptr;
+    uint32 mapId = 0;
+    uint32 instanceId = 0;
+    uint32 generation = 0;
+    BotMapDecision* decision = nullptr;
+};
+
+thread_local BotDecisionCache _decisionCache;
+
+uint64 GetDecisionKey(Map const* map)
+{
+    return (uint64(map->GetId()) << 32) | map->GetInstanceId();
+}
+
+BotMapDecision& GetDecision(Map const* map)
+{
+    BotDecisionCache& cache = _decisionCache;
+    uint32 generation = _mapDecisionsGeneration.load();
+    if (cache.map != map || cache.mapId != map->GetId() || cache.instanceId != map->GetInstanceId() || cache.generation != generation)
+    {
+        std::lock_guard<std::mutex> lock(_mapDecisionsLock);
+        cache.map = map;
+        cache.mapId = map->GetId();
+        cache.instanceId = map->GetInstanceId();
+        cache.generation = generation;
+        cache.decision = &_mapDecisions[GetDecisionKey(map)]; //node-based, pointer stays valid
+    }
+
+    return *cache.decision;
+}
+
+void RunDecidePhase(Map* map, BotMapDecision& decision, uint32 diff)
+{
+    BotDecisionJob& job = decision.job;
+    job.bots.clear();
+    for (ObjectGuid guid : decision.bots)
+    {
+        Creature const* bot = map->GetCreature(guid);
+        if (bot && bot->IsInWorld() && bot->GetBotAI())
+            job.bots.push_back(bot->GetBotAI());
+    }
+
+    if (job.bots.size() < BOT_DECISION_MIN_BOTS)
+        return;
+
+    BotDecisionWorkers* workers = GetWorkers();
+    job.diff = diff;
+    job.next = 0;
+    job.helpers = std::min<uint32>(workers->GetCount(), uint32(job.bots.size() / BOT_DECISION_MIN_BOTS));
+    for (uint32 i = 0; i != job.helpers; ++i)
+        workers->Push(&job);
+
+    job.Run();
+    job.WaitForHelpers();
+}
+
+}
+
+bool BotDecisionPipeline::IsEnabled()
+{
+    return BotMgr::GetBotDecisionThreads() != 0;
+}
+
+void BotDecisionPipeline::OnBotUpdate(Creature const* bot, uint32 diff)
+{
+    if (!IsEnabled() || !bot->IsInWorld())
+        return;
+
+    //continent regions are already updated in parallel
+    Map* map = bot->GetMap();
+    if (map->IsUpdatingRegions())
+        return;
+
+    BotMapDecision& decision = GetDecision(map);
+    Milliseconds tick = GameTime::GetGameTimeMS();
+    if (decision.tick != tick)
+    {
+        decision.tick = tick;
+        decision.bots.swap(decision.seen);
+        decision.seen.clear();
+        RunDecidePhase(map, decision, diff);
+    }
+
+    decision.seen.push_back(bot->GetGUID());
+}
+
+void BotDecisionPipeline::OnMapUnload(Map const* map)
+{
+    //decide phase never outlives map update, no worker can be using the entry
+    std::lock_guard<std::mutex> lock(_mapDecisionsLock);
+    if (_mapDecisions.erase(GetDecisionKey(map)))
+        ++_mapDecisionsGeneration;
+}
+
+#ifdef _MSC_VER
+# pragma warning(pop)
+#endif
@@ -0,0 +1,34 @@
+#ifndef _BOT_DECISION_H
+#define _BOT_DECISION_H
+
+#include "Define.h"
+
+class Creature;
+class Map;
+
+/*
+Two-phase bot update within a map update.
+Decide phase: when the first bot on a map is updated in a world tick, bots that are going to run
+their AI this tick do their read-only preparation (neighborhood classification for target and spell
+selection) in parallel on a pool of NpcBot.DecisionThreads worker threads. Map thread takes part too
+and waits for all of them to finish, so nothing else on the map runs meanwhile.
+Apply phase: regular serial UpdateAI, which picks up results prepared for this tick
+and issues casts and movement as usual.
+Bots are collected from previous tick, new bots join the decide phase on their second tick
+*/
+class BotDecisionPipeline
+{
+    public:
+        //Called by bot at the start of its update
+        static void OnBotUpdate(Creature const* bot, uint32 diff);
+        //Drops map's decision state, called when map is destroyed
+        static void OnMapUnload(Map const* map);
+
+        static bool IsEnabled();
+
+    private:
+        BotDecisionPipeline() {}
+        BotDecisionPipeline(BotDecisionPipeline const&);
+};
+
+#endif
@@ -6,32 +6,27 @@ Name: bot_dps_tracker
 %Complete: 100
 Comment: dps taken tracker for NPCBot system by Trickerer (onlysuffering@gmail.com)
 DPS trackers may collect data from different bot owners if in party but this overdoing has no significance whatsoever
+Damage is stored in fixed ring buffers of DPS_BUCKET_TIME buckets with running sums per window, so tracking damage
+and querying dps never allocate
 */
 
 enum DPSTrackerConstants : uint32
 {
-    DPS_UPDATE_TIMER        =  500, //recalculate dps every x ms
-    MAX_DPS_TRACK_TIME      = 5000, //track damage taken for last x ms
     DPS_INACTIVE_TIMER      = 5000, //reset if combat not active for botparty for x ms
-    //maximum tracked damage taken periods of DPS_UPDATE_TIMER during MAX_DPS_TRACK_TIME
-    MAX_DAMAGES             = MAX_DPS_TRACK_TIME/DPS_UPDATE_TIMER
 };
 
+//window lengths in buckets
+static constexpr std::array<uint32, MAX_DPS_WINDOWS> DPSWindowBuckets = { 2, 10, 60 };
+
 DPSTracker::DPSTracker()
 {
     _updateTimer = 0;
     _inactiveTimer = 0;
     _trackTimer = 0;
     _active = false;
-}
-
-DPSTracker::~DPSTracker()
-{
-    for (DamageTakenMap::const_iterator itr = _damages.begin(); itr != _damages.end(); ++itr)
-        delete[] itr->second;
-
-    _damages.clear();
-    _DPSes.clear();
+    _trackedCount = 0;
+    _head = 0;
+    _table.fill(0);
 }
 
 void DPSTracker::Update(uint32 diff)
@@ -46,10 +41,13 @@ void DPSTracker::Update(uint32 diff)
         {
             _Reset();
         }
-        else if (_updateTimer >= DPS_UPDATE_TIMER)
+        else
         {
-            _updateTimer -= DPS_UPDATE_TIMER;
-            _Release();
+            while (_updateTimer >= DPS_BUCKET_TIME)
+            {
+                _updateTimer -= DPS_BUCKET_TIME;
+                _Advance();
+            }
         }
     }
 }
@@ -60,11 +58,9 @@ void DPSTracker::_Reset()
     {
         _active = false;
 
-        for (DamageTakenMap::const_iterator itr = _damages.begin(); itr != _damages.end(); ++itr)
-            for (uint8 i = 0; i != MAX_DAMAGES; ++i)
-                itr->second[i] = 0;
-        for (DPSTakenMap::iterator itr = _DPSes.begin(); itr != _DPSes.end(); ++itr)
-            itr->second = 0;
+        _table.fill(0);
+        _trackedCount = 0;
+        _head = 0;
 
         _updateTimer = 0;
         _inactiveTimer = 0;
@@ -72,42 +68,49 @@ void DPSTracker::_Reset()
     }
 }
 
-void DPSTracker::_Release()
+void DPSTracker::_Advance()
 {
-    for (DamageTakenMap::const_iterator itr = _damages.begin(); itr != _damages.end(); ++itr)
+    _head = (_head + 1) % DPS_BUCKETS;
+    for (uint32 i = 0; i != _trackedCount; ++i)
     {
-        uint32* dmgs = itr->second;
-        uint32 total_damage = 0;
-        for (uint8 i = 0; i != MAX_DAMAGES; ++i)
-            total_damage += dmgs[i];
-
-        _DPSes[itr->first] = uint32(total_damage / (0.001f * std::max<uint32>(1 * IN_MILLISECONDS, std::min<uint32>(_trackTimer, MAX_DPS_TRACK_TIME))));
-        //TC_LOG_ERROR("entities.player", "DPSTracker::Release(): guidlow = %u, time = %u, tick damage %u, total %u, dps = %u",
-        //    itr->first, _trackTimer, dmgs[0], total_damage, _DPSes[itr->first]);
-
-        //shift
-        for (int8 i = MAX_DAMAGES-1; i > 0; --i)
-            dmgs[i] = dmgs[i-1];
-        dmgs[0] = 0;
+        TrackedDamage& td = _tracked[i];
+        //drop buckets leaving each window (30s window drops the bucket being reused)
+        for (uint8 w = 0; w != MAX_DPS_WINDOWS; ++w)
+            td.sums[w] -= td.buckets[(_head + DPS_BUCKETS - DPSWindowBuckets[w]) % DPS_BUCKETS];
+        td.buckets[_head] = 0;
     }
 }
 
-void DPSTracker::_AccumulateDamage(uint64 guid, uint32 damage)
+DPSTracker::TrackedDamage const* DPSTracker::_Find(uint64 guid) const
 {
-    DamageTakenMap::const_iterator itr = _damages.find(guid);
-
-    if (itr == _damages.end())
+    for (uint32 i = uint32(guid * 0x9E3779B97F4A7C15ull >> 32) & (TABLE_SIZE - 1);; i = (i + 1) & (TABLE_SIZE - 1))
     {
-        uint32* dmgarray = new uint32[MAX_DAMAGES];
-        memset(dmgarray, 0, sizeof(uint32)*MAX_DAMAGES);
-
-        dmgarray[0] = damage;
+        if (!_table[i])
+            return nullptr;
+        if (_tracked[_table[i] - 1].guid == guid)
+            return &_tracked[_table[i] - 1];
+    }
+}
 
-        _damages[guid] = dmgarray;
-        return;
+DPSTracker::TrackedDamage* DPSTracker::_FindOrAdd(uint64 guid)
+{
+    uint32 i = uint32(guid * 0x9E3779B97F4A7C15ull >> 32) & (TABLE_SIZE - 1);
+    for (; _table[i]; i = (i + 1) & (TABLE_SIZE - 1))
+    {
+        if (_tracked[_table[i] - 1].guid == guid)
+            return &_tracked[_table[i] - 1];
     }
 
-    itr->second[0] += damage;
+    //table is never more than half full; extra victims are ignored until next reset
+    if (_trackedCount >= MAX_TRACKED)
+        return nullptr;
+
+    TrackedDamage& td = _tracked[_trackedCount];
+    td.guid = guid;
+    td.buckets.fill(0);
+    td.sums.fill(0);
+    _table[i] = uint8(++_trackedCount);
+    return &td;
 }
 //victim is bot owner, bot, party player or party bot; checked in Unit::DealDamage()
 void DPSTracker::TrackDamage(Unit const* victim, uint32 damage)
@@ -115,7 +118,12 @@ void DPSTracker::TrackDamage(Unit const* victim, uint32 damage)
     //TC_LOG_ERROR("entities.player", "DPSTracker::OnDamage(): on %s, damage %u", victim->GetName().c_str(), damage);
 
     _SetActive();
-    _AccumulateDamage(victim->GetGUID().GetRawValue(), damage);
+    if (TrackedDamage* td = _FindOrAdd(victim->GetGUID().GetRawValue()))
+    {
+        td->buckets[_head] += damage;
+        for (uint8 w = 0; w != MAX_DPS_WINDOWS; ++w)
+            td->sums[w] += damage;
+    }
 }
 
 void DPSTracker::_SetActive()
@@ -125,9 +133,13 @@ void DPSTracker::_SetActive()
         _active = true;
 }
 
-uint32 DPSTracker::GetDPSTaken(uint64 guid) const
+uint32 DPSTracker::GetDPSTaken(uint64 guid, DPSTrackerWindow window) const
 {
-    DPSTakenMap::const_iterator itr = _DPSes.find(guid);
-    //TC_LOG_ERROR("entities.player", "DPSTracker::GetDPSTaken(): from %u, damage %u", guid, itr != _DPSes.end() ? itr->second : 0);
-    return itr != _DPSes.end() ? itr->second : 0;
+    TrackedDamage const* td = _Find(guid);
+    if (!td)
+        return 0;
+
+    uint32 windowTime = DPSWindowBuckets[window] * DPS_BUCKET_TIME;
+    //TC_LOG_ERROR("entities.player", "DPSTracker::GetDPSTaken(): from %u, damage %u", guid, td->sums[window]);
+    return uint32(td->sums[window] / (0.001f * std::max<uint32>(1 * IN_MILLISECONDS, std::min<uint32>(_trackTimer, windowTime))));
 }
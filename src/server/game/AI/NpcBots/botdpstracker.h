@@ -3,31 +3,52 @@
 
 #include "Define.h"
 
-#include <unordered_map>
+#include <array>
 
 class Unit;
 
+enum DPSTrackerWindow : uint8
+{
+    DPS_WINDOW_1S       = 0,
+    DPS_WINDOW_5S       = 1,
+    DPS_WINDOW_30S      = 2,
+    MAX_DPS_WINDOWS
+};
+
 class DPSTracker
 {
     public:
         DPSTracker();
-        ~DPSTracker();
 
         void Update(uint32 diff);
 
         void TrackDamage(Unit const* victim, uint32 damage);
-        uint32 GetDPSTaken(uint64 guid) const;
+        uint32 GetDPSTaken(uint64 guid, DPSTrackerWindow window = DPS_WINDOW_5S) const;
 
     private:
+        //damage taken per bucket for last 30 seconds
+        static constexpr uint32 DPS_BUCKET_TIME = 500;
+        static constexpr uint32 DPS_BUCKETS = 60;
+        static constexpr uint32 MAX_TRACKED = 64;
+        static constexpr uint32 TABLE_SIZE = MAX_TRACKED * 2; //power of 2
+
+        struct TrackedDamage
+        {
+            uint64 guid;
+            std::array<uint32, DPS_BUCKETS> buckets;
+            std::array<uint32, MAX_DPS_WINDOWS> sums;
+        };
+
         void _Reset();
-        void _Release();
-        void _AccumulateDamage(uint64 guid, uint32 damage);
+        void _Advance();
+        TrackedDamage* _FindOrAdd(uint64 guid);
+        TrackedDamage const* _Find(uint64 guid) const;
         void _SetActive();
 
-        typedef std::unordered_map<uint64 /*guid*/, uint32* /*dmgarray*/> DamageTakenMap;
-        typedef std::unordered_map<uint64 /*guid*/, uint32 /*dps*/> DPSTakenMap;
-        DamageTakenMap _damages;
-        DPSTakenMap _DPSes;
+        std::array<TrackedDamage, MAX_TRACKED> _tracked;
+        std::array<uint8, TABLE_SIZE> _table; //open addressing: slot index + 1, 0 is empty
+        uint32 _trackedCount;
+        uint32 _head;
 
         uint32 _updateTimer;
         uint32 _inactiveTimer;
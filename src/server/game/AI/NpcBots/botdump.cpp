@@ -9,6 +9,14 @@
  * 3) `item_instance` - bots' equipment
  * 4) `creature` - bot spawns
  *
+ * Dump formats:
+ * 1) SQL statements (legacy, load only)
+ * 2) "NPCBOTS DUMP 2": sections of tab separated rows, one row per line, written and read as a stream.
+ *    Section starts with "#table_name<TAB>columns_count", dump ends with "#end<TAB>bots_count".
+ *    Strings are escaped (\\, \t, \n), NULL is written as \N.
+ *    Items go first so bots' equipment guids can be remapped on the fly,
+ *    rows are imported with multi-row inserts in one transaction per database
+ *
  * Make sure you have bots installed, or you are in for an unpleasant surprise.
  */
 
@@ -17,28 +25,13 @@
 #include "DatabaseEnv.h"
 #include "Log.h"
 #include "ObjectMgr.h"
+#include "StringConvert.h"
+#include "Timer.h"
+#include "Tokenize.h"
 
+#include <array>
 #include <sstream>
 
-class BotStringTransaction
-{
-public:
-    BotStringTransaction() : _buf() {}
-
-    void Append(std::string const& sql)
-    {
-        _buf += sql;
-    }
-
-    std::string const& GetBuffer() const
-    {
-        return _buf;
-    }
-
-private:
-    std::string _buf;
-};
-
 enum ImportDataTableType : uint8
 {
     TABLE_TYPE_CHARACTERS_NPCBOT    = 0,
@@ -57,6 +50,8 @@ struct TableImportData
     uint32 paramsCount;
     size_t guidOffsetBegin;
     size_t guidOffsetEnd;
+    //stream dump column types: u - uint32, i - int32, f - float, s - string (can be NULL)
+    char const* columnTypes;
 };
 
 TableImportData TableImportDatas[IMPORT_TABLES_COUNT] =
@@ -69,13 +64,13 @@ TableImportData TableImportDatas[IMPORT_TABLES_COUNT] =
       "`equipShoulders`,`equipChest`,`equipWaist`,`equipLegs`,`equipFeet`,`equipWrist`,`equipHands`,`equipBack`,"
       //18          19             20             21              22              23
       "`equipBody`,`equipFinger1`,`equipFinger2`,`equipTrinket1`,`equipTrinket2`,`equipNeck`"
-      ") VALUES ", 24, 6, 23 },
+      ") VALUES ", 24, 6, 23, "uuuuusuuuuuuuuuuuuuuuuuu" },
 
     { "`characters_npcbot_transmog` ",
       "("
       //0       1      2         3
       "`entry`,`slot`,`item_id`,`fake_id`"
-      ") VALUES ", 4, 0, 0 },
+      ") VALUES ", 4, 0, 0, "uuuu" },
 
     { "`item_instance` ",
       "("
@@ -83,15 +78,27 @@ TableImportData TableImportDatas[IMPORT_TABLES_COUNT] =
       "`creatorGuid`,`giftCreatorGuid`,`count`,`duration`,`charges`,`flags`,`enchantments`,"
       //7                  8            9            10     11     12          13
       "`randomPropertyId`,`durability`,`playedTime`,`text`,`guid`,`itemEntry`,`owner_guid`"
-      ") VALUES ", 14, 11, 11 },
+      ") VALUES ", 14, 11, 11, "uuuususiuusuuu" },
 
     { "`creature` ",
       "("
       //0      1    2     3           4           5            6            7            8             9           10
       "`guid`,`id1`,`map`,`spawnMask`,`phaseMask`,`position_x`,`position_y`,`position_z`,`orientation`,`curhealth`,`curmana`"
-      ") VALUES ", 11, 0, 0 }
+      ") VALUES ", 11, 0, 0, "uuuuuffffuu" }
 };
 
+std::string const DumpHeaderV2 = "NPCBOTS DUMP 2";
+std::string const DumpNoteLine = "IMPORTANT NOTE:";
+std::string const DumpEndSection = "end";
+static const uint32 DumpInsertBatchRows = 500;
+
+inline std::string_view GetDumpSectionName(ImportDataTableType type)
+{
+    //"`name` " -> "name"
+    std::string const& name = TableImportDatas[type].name;
+    return std::string_view(name).substr(1, name.find('`', 1) - 1);
+}
+
 ImportDataTableType GetImportDataTableType(std::string const& name)
 {
     for (uint8 i = TABLE_TYPE_CHARACTERS_NPCBOT; i != IMPORT_TABLES_COUNT; ++i)
@@ -437,18 +444,9 @@ inline bool ReGuidCreature(std::string& line)
     return reguidDone;
 }
 
-BotDataDumpResult NPCBotsDump::Load(std::string const& file)
+//prepare data for existing entries checks
+static void LoadExistingEntries()
 {
-    std::ifstream input(file.c_str());
-    if (!input)
-        return BOT_DUMP_FAIL_FILE_NOT_EXIST;
-
-    return LoadDump(input);
-}
-
-BotDataDumpResult NPCBotsDump::LoadDump(std::ifstream& input)
-{
-    //prepare data for existing entries checks
     //bot entry
     //first - from `characters_npcbot`
     QueryResult result = CharacterDatabase.Query("SELECT `entry` FROM `characters_npcbot`");
@@ -481,10 +479,45 @@ BotDataDumpResult NPCBotsDump::LoadDump(std::ifstream& input)
             ExistingNPCBotTransmogs.insert((*fields).Get<uint32>());
         } while (result->NextRow());
     }
+}
+
+BotDataDumpResult NPCBotsDump::Load(std::string const& file)
+{
+    std::ifstream input(file.c_str(), std::ios::binary);
+    if (!input)
+        return BOT_DUMP_FAIL_FILE_NOT_EXIST;
+
+    uint32 oldMSTime = getMSTime();
+    _stats = BotDataDumpStats();
+
+    input.seekg(0, std::ios::end);
+    _stats.bytes = uint64(input.tellg());
+    input.seekg(0, std::ios::beg);
+
+    //format is determined by header, anything else is a legacy SQL dump
+    BotDataDumpResult res;
+    std::string header;
+    if (std::getline(input, header) && !header.compare(0, DumpHeaderV2.size(), DumpHeaderV2))
+        res = LoadStreamDump(input);
+    else
+    {
+        input.clear();
+        input.seekg(0, std::ios::beg);
+        res = LoadDump(input);
+    }
+
+    _stats.timeMs = GetMSTimeDiffToNow(oldMSTime);
+    return res;
+}
+
+BotDataDumpResult NPCBotsDump::LoadDump(std::ifstream& input)
+{
+    LoadExistingEntries();
+
     //item guid
-    result = CharacterDatabase.Query("SELECT MAX(`guid`) FROM `item_instance`");
+    QueryResult result = CharacterDatabase.Query("SELECT MAX(`guid`) FROM `item_instance`");
     ASSERT(result);
-    fields = result->Fetch();
+    Field* fields = result->Fetch();
     static uint32 NextItemGuid = (*fields).Get<uint32>() + 1;
     //TC_LOG_ERROR("scripts", "import: NextItemGuid %u", NextItemGuid);
 
@@ -599,6 +632,9 @@ BotDataDumpResult NPCBotsDump::LoadDump(std::ifstream& input)
             }
 
             curExecLine += line;
+            ++_stats.rows;
+            if (curImportDataTableType == TABLE_TYPE_CHARACTERS_NPCBOT)
+                ++_stats.bots;
 
             //multi-line import
             if (line[line.size()-1] == ',')
@@ -695,43 +731,364 @@ BotDataDumpResult NPCBotsDump::LoadDump(std::ifstream& input)
     return BOT_DUMP_SUCCESS;
 }
 
-BotDataDumpResult NPCBotsDump::Write(std::string const& file)
+//Appends stream dump row to a multi-row insert, values are validated against column types
+static bool AppendStreamDumpRow(std::string& sql, ImportDataTableType type, std::vector<std::string_view> const& tokens)
 {
-    if (FILE* f = fopen(file.c_str(), "r"))
+    static std::string const NullToken = "\\N";
+
+    char const* types = TableImportDatas[type].columnTypes;
+
+    sql += '(';
+    for (size_t i = 0; i != tokens.size(); ++i)
     {
-        fclose(f);
-        return BOT_DUMP_FAIL_FILE_ALREADY_EXISTS;
+        if (i)
+            sql += ',';
+
+        std::string_view token = tokens[i];
+        switch (types[i])
+        {
+            case 's':
+            {
+                if (token == NullToken)
+                {
+                    sql += "NULL";
+                    break;
+                }
+
+                std::string str;
+                str.reserve(token.size());
+                for (size_t j = 0; j != token.size(); ++j)
+                {
+                    if (token[j] != '\\' || j + 1 == token.size())
+                    {
+                        str += token[j];
+                        continue;
+                    }
+                    switch (token[++j])
+                    {
+                        case 't': str += '\t'; break;
+                        case 'n': str += '\n'; break;
+                        default:  str += token[j]; break;
+                    }
+                }
+                CharacterDatabase.EscapeString(str);
+                sql += '\'';
+                sql += str;
+                sql += '\'';
+                break;
+            }
+            case 'i':
+                if (!Acore::StringTo<int32>(token))
+                    return false;
+                sql += token;
+                break;
+            case 'f':
+                if (!Acore::StringTo<float>(token))
+                    return false;
+                sql += token;
+                break;
+            default:
+                if (!Acore::StringTo<uint32>(token))
+                    return false;
+                sql += token;
+                break;
+        }
     }
+    sql += ')';
 
-    BotDataDumpResult ret = BOT_DUMP_SUCCESS;
-    std::string dumpstr;
-    if (!GetDump(dumpstr))
-        ret = BOT_DUMP_FAIL_INCOMPLETE;
-    else
+    return true;
+}
+
+BotDataDumpResult NPCBotsDump::LoadStreamDump(std::ifstream& input)
+{
+    LoadExistingEntries();
+
+    QueryResult result = CharacterDatabase.Query("SELECT MAX(`guid`) FROM `item_instance`");
+    ASSERT(result);
+    uint32 nextItemGuid = result->Fetch()[0].Get<uint32>() + 1;
+
+    CharacterDatabaseTransaction ctrans = CharacterDatabase.BeginTransaction();
+    WorldDatabaseTransaction wtrans = WorldDatabase.BeginTransaction();
+
+    ImportDataTableType curType = IMPORT_TABLE_INVALID;
+    std::string sql;
+    uint32 sqlRows = 0;
+    auto flush = [&]() {
+        if (!sqlRows)
+            return;
+        if (curType == TABLE_TYPE_CREATURE)
+            wtrans->Append(sql);
+        else
+            ctrans->Append(sql);
+        sql.clear();
+        sqlRows = 0;
+    };
+
+    ReGuidMap itemGuids;
+    std::array<std::string, 24> remapped;
+    bool ended = false;
+
+    std::string line;
+    uint32 lineNum = 1;
+    while (std::getline(input, line))
     {
-        FILE* fout = fopen(file.c_str(), "w");
-        if (!fout)
-            return BOT_DUMP_FAIL_CANT_WRITE_TO_FILE;
+        ++lineNum;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || !line.compare(0, DumpNoteLine.size(), DumpNoteLine))
+            continue;
+
+        if (ended)
+        {
+            LOG_ERROR("scripts", "import: unexpected data after dump end at line {}", lineNum);
+            return BOT_DUMP_FAIL_FILE_CORRUPTED;
+        }
+
+        std::vector<std::string_view> tokens = Acore::Tokenize(line, '\t', true);
+
+        //section header
+        if (line[0] == '#')
+        {
+            flush();
+
+            Optional<uint32> val = tokens.size() == 2 ? Acore::StringTo<uint32>(tokens[1]) : std::nullopt;
+            if (!val)
+            {
+                LOG_ERROR("scripts", "import: invalid section header at line {}", lineNum);
+                return BOT_DUMP_FAIL_FILE_CORRUPTED;
+            }
+
+            std::string_view name = tokens[0].substr(1);
+            if (name == DumpEndSection)
+            {
+                if (*val != _stats.bots)
+                {
+                    LOG_ERROR("scripts", "import: dump contains {} bots but {} were expected", _stats.bots, *val);
+                    return BOT_DUMP_FAIL_FILE_CORRUPTED;
+                }
+                ended = true;
+                continue;
+            }
+
+            curType = IMPORT_TABLE_INVALID;
+            for (uint8 i = TABLE_TYPE_CHARACTERS_NPCBOT; i != IMPORT_TABLES_COUNT; ++i)
+                if (GetDumpSectionName(ImportDataTableType(i)) == name)
+                    curType = ImportDataTableType(i);
+
+            if (curType == IMPORT_TABLE_INVALID || *val != TableImportDatas[curType].paramsCount)
+            {
+                LOG_ERROR("scripts", "import: unknown section {} ({} columns) at line {}", std::string(name), *val, lineNum);
+                return BOT_DUMP_FAIL_FILE_CORRUPTED;
+            }
+            continue;
+        }
+
+        if (curType == IMPORT_TABLE_INVALID || tokens.size() != TableImportDatas[curType].paramsCount)
+        {
+            LOG_ERROR("scripts", "import: invalid param count {} at line {}", uint32(tokens.size()), lineNum);
+            return BOT_DUMP_FAIL_FILE_CORRUPTED;
+        }
+
+        //check values conflicts and reguid
+        Optional<uint32> entry = Acore::StringTo<uint32>(tokens[0]);
+        switch (curType)
+        {
+            case TABLE_TYPE_CHARACTERS_NPCBOT:
+            {
+                if (!entry || ExistingNPCBots.find(*entry) != ExistingNPCBots.end())
+                {
+                    LOG_ERROR("scripts", "import: NPCBot id {} already exists in `characters_npcbot` or `creature` table! Aborting", std::string(tokens[0]));
+                    return BOT_DUMP_FAIL_DATA_OCCUPIED;
+                }
+                for (size_t i = TableImportDatas[curType].guidOffsetBegin; i <= TableImportDatas[curType].guidOffsetEnd; ++i)
+                {
+                    Optional<uint32> guid = Acore::StringTo<uint32>(tokens[i]);
+                    if (guid && !*guid)
+                        continue;
+
+                    ReGuidMap::const_iterator itr = guid ? itemGuids.find(*guid) : itemGuids.cend();
+                    if (itr == itemGuids.cend())
+                    {
+                        LOG_ERROR("scripts", "import: reguid value not found for bot {} equip {} at line {}!", *entry, std::string(tokens[i]), lineNum);
+                        return BOT_DUMP_FAIL_FILE_CORRUPTED;
+                    }
+                    remapped[i] = Acore::ToString(itr->second);
+                    tokens[i] = remapped[i];
+                }
+                ++_stats.bots;
+                break;
+            }
+            case TABLE_TYPE_NPCBOT_TRANSMOG:
+                if (!entry || ExistingNPCBotTransmogs.find(*entry) != ExistingNPCBotTransmogs.end())
+                {
+                    LOG_ERROR("scripts", "import: NPCBot id {} already exists in `characters_npcbot_transmog` table! Aborting", std::string(tokens[0]));
+                    return BOT_DUMP_FAIL_DATA_OCCUPIED;
+                }
+                break;
+            case TABLE_TYPE_ITEM_INSTANCE:
+            {
+                size_t offset = TableImportDatas[curType].guidOffsetBegin;
+                Optional<uint32> guid = Acore::StringTo<uint32>(tokens[offset]);
+                if (!guid || !*guid)
+                {
+                    LOG_ERROR("scripts", "import: no item guid at line {}!", lineNum);
+                    return BOT_DUMP_FAIL_FILE_CORRUPTED;
+                }
+                //this is not checked at dump save
+                if (!itemGuids.emplace(*guid, nextItemGuid).second)
+                    LOG_ERROR("scripts", "import: item guid {} was already reguided to {}. Saved dump contains duplicate item guids - you'll have to fix them manually, proceeding anyways...",
+                        *guid, itemGuids[*guid]);
+                remapped[offset] = Acore::ToString(nextItemGuid++);
+                tokens[offset] = remapped[offset];
+                break;
+            }
+            case TABLE_TYPE_CREATURE:
+                remapped[0] = Acore::ToString(sObjectMgr->GenerateCreatureSpawnId());
+                tokens[0] = remapped[0];
+                break;
+            default:
+                break;
+        }
+
+        if (!sqlRows)
+            sql = "INSERT INTO " + TableImportDatas[curType].name + TableImportDatas[curType].fieldsStr;
+        else
+            sql += ',';
+
+        if (!AppendStreamDumpRow(sql, curType, tokens))
+        {
+            LOG_ERROR("scripts", "import: invalid value at line {}", lineNum);
+            return BOT_DUMP_FAIL_FILE_CORRUPTED;
+        }
+
+        ++_stats.rows;
+        if (++sqlRows >= DumpInsertBatchRows)
+            flush();
+    }
 
-        fprintf(fout, "%s", dumpstr.c_str());
-        fclose(fout);
+    if (!ended)
+    {
+        LOG_ERROR("scripts", "import: unexpected file ending at line {}!", lineNum);
+        return BOT_DUMP_FAIL_FILE_CORRUPTED;
     }
 
-    return ret;
+    CharacterDatabase.CommitTransaction(ctrans);
+    WorldDatabase.CommitTransaction(wtrans);
+
+    return BOT_DUMP_SUCCESS;
 }
 
-bool NPCBotsDump::GetDump(std::string& dump)
+struct BotDumpCreatureRow
+{
+    uint32 guid;
+    uint32 map;
+    uint32 spawnMask;
+    uint32 phaseMask;
+    float x, y, z, o;
+    uint32 curhealth;
+    uint32 curmana;
+};
+
+//Writes stream dump rows straight into the file
+class BotDumpWriter
 {
+public:
+    explicit BotDumpWriter(std::ofstream& out) : _out(out), _first(true), _rows(0)
+    {
+        _out.setf(std::ios_base::fixed);
+        _out.precision(6);
+    }
+
+    void BeginSection(ImportDataTableType type)
+    {
+        _out << '#' << GetDumpSectionName(type) << '\t' << TableImportDatas[type].paramsCount << '\n';
+    }
+
+    void EndDump(uint32 bots)
+    {
+        _out << '#' << DumpEndSection << '\t' << bots << '\n';
+    }
+
+    template<typename T>
+    BotDumpWriter& operator<<(T const& val)
+    {
+        Separate();
+        _out << val;
+        return *this;
+    }
+
+    //empty strings are saved as NULL, same as in SQL dumps
+    void String(std::string const& str)
+    {
+        Separate();
+        if (str.empty())
+        {
+            _out << "\\N";
+            return;
+        }
+        for (char c : str)
+        {
+            switch (c)
+            {
+                case '\\': _out << "\\\\"; break;
+                case '\t': _out << "\\t"; break;
+                case '\n': _out << "\\n"; break;
+                default:   _out << c; break;
+            }
+        }
+    }
+
+    void EndRow()
+    {
+        _out << '\n';
+        _first = true;
+        ++_rows;
+    }
+
+    uint32 GetRowsCount() const { return _rows; }
+
+private:
+    void Separate()
+    {
+        if (!_first)
+            _out << '\t';
+        _first = false;
+    }
+
+    std::ofstream& _out;
+    bool _first;
+    uint32 _rows;
+};
+
+BotDataDumpResult NPCBotsDump::Write(std::string const& file)
+{
+    if (FILE* f = fopen(file.c_str(), "r"))
+    {
+        fclose(f);
+        return BOT_DUMP_FAIL_FILE_ALREADY_EXISTS;
+    }
+
+    uint32 oldMSTime = getMSTime();
+    _stats = BotDataDumpStats();
+
     //bots are disabled but we need that data
     if (!BotDataMgr::AllBotsLoaded())
         BotDataMgr::LoadNpcBots(false);
 
-    dump = "";
-
-    dump += "IMPORTANT NOTE: THIS DUMPFILE IS MADE FOR USE WITH THE 'NPCBOT DUMP' COMMAND ONLY - EITHER THROUGH INGAME CHAT OR ON CONSOLE!\n";
-    dump += "IMPORTANT NOTE: DO NOT apply it directly - it will irreversibly DAMAGE and CORRUPT your database! You have been warned!\n\n";
-
-    BotStringTransaction trans;
+    //all bot spawns in one query
+    std::unordered_map<uint32, std::vector<BotDumpCreatureRow>> spawns;
+    QueryResult cresult = WorldDatabase.Query("SELECT `guid`,`id1`,`map`,`spawnMask`,`phaseMask`,`position_x`,`position_y`,`position_z`,`orientation`,`curhealth`,`curmana` "
+        "FROM `creature` WHERE `id1` IN (SELECT `entry` FROM `creature_template_npcbot_extras`)");
+    if (cresult)
+    {
+        do
+        {
+            Field* fields = cresult->Fetch();
+            spawns[fields[1].Get<uint32>()].push_back({ fields[0].Get<uint32>(), uint32(fields[2].Get<uint16>()), uint32(fields[3].Get<uint8>()), fields[4].Get<uint32>(),
+                fields[5].Get<float>(), fields[6].Get<float>(), fields[7].Get<float>(), fields[8].Get<float>(), fields[9].Get<uint32>(), fields[10].Get<uint32>() });
+        } while (cresult->NextRow());
+    }
 
     std::set<uint32> valid_ids;
     bool integrityChecked = true;
@@ -741,7 +1098,7 @@ bool NPCBotsDump::GetDump(std::string& dump)
         if (i >= BOT_ENTRY_CREATE_BEGIN && BotDataMgr::GetBotExtraCreatureTemplate(i))
             continue;
 
-        BotDataVerificationResult res = VerifyWriteData(i);
+        BotDataVerificationResult res = VerifyWriteData(i, spawns);
         if (res == BOT_DATA_INCOMPLETE)
         {
             if (integrityChecked)
@@ -752,22 +1109,35 @@ bool NPCBotsDump::GetDump(std::string& dump)
     }
 
     if (!integrityChecked || valid_ids.empty())
-        return false;
+        return BOT_DUMP_FAIL_INCOMPLETE;
 
-    for (std::set<uint32>::const_iterator ci = valid_ids.begin(); ci != valid_ids.end(); ++ci)
-    {
-        AppendBotNPCBotData(&trans, *ci);
-        AppendBotNPCBotTransmogData(&trans, *ci);
-        AppendBotEquipsData(&trans, *ci);
-        AppendBotCreatureData(&trans, *ci);
-    }
+    std::ofstream out(file.c_str(), std::ios::binary);
+    if (!out)
+        return BOT_DUMP_FAIL_CANT_WRITE_TO_FILE;
 
-    dump += trans.GetBuffer();
+    out << DumpHeaderV2 << '\n';
+    out << DumpNoteLine << " THIS DUMPFILE IS MADE FOR USE WITH THE 'NPCBOT DUMP' COMMAND ONLY - EITHER THROUGH INGAME CHAT OR ON CONSOLE!\n\n";
 
-    return true;
+    BotDumpWriter writer(out);
+    WriteBotEquipsData(writer, valid_ids);
+    WriteBotNPCBotData(writer, valid_ids);
+    WriteBotNPCBotTransmogData(writer, valid_ids);
+    WriteBotCreatureData(writer, valid_ids, spawns);
+    writer.EndDump(uint32(valid_ids.size()));
+
+    out.flush();
+    if (!out)
+        return BOT_DUMP_FAIL_CANT_WRITE_TO_FILE;
+
+    _stats.bots = uint32(valid_ids.size());
+    _stats.rows = writer.GetRowsCount();
+    _stats.bytes = uint64(out.tellp());
+    _stats.timeMs = GetMSTimeDiffToNow(oldMSTime);
+
+    return BOT_DUMP_SUCCESS;
 }
 
-BotDataVerificationResult NPCBotsDump::VerifyWriteData(uint32 entry) const
+BotDataVerificationResult NPCBotsDump::VerifyWriteData(uint32 entry, std::unordered_map<uint32, std::vector<BotDumpCreatureRow>> const& spawns) const
 {
     NpcBotData const* botData = BotDataMgr::SelectNpcBotData(entry);
 
@@ -778,247 +1148,119 @@ BotDataVerificationResult NPCBotsDump::VerifyWriteData(uint32 entry) const
     EquipmentInfo const* deinfo = BotDataMgr::GetBotEquipmentInfo(entry);
     if (!deinfo)
     {
-        LOG_ERROR("scripts", "NPCBotsDump::AppendBotCreatureData creature {} is not found in `creature_equip_template` table!", entry);
+        LOG_ERROR("scripts", "NPCBotsDump::VerifyWriteData creature {} is not found in `creature_equip_template` table!", entry);
         return BOT_DATA_INCOMPLETE;
     }
 
-    QueryResult result = WorldDatabase.Query("SELECT `guid` FROM `creature` WHERE `id1` = {}", entry);
+    auto itr = spawns.find(entry);
 
     //creature is not spawned, corrupted
-    if (!result)
+    if (itr == spawns.cend())
     {
-        LOG_ERROR("scripts", "NPCBotsDump::AppendBotCreatureData creature {} is not found in `creature` table!", entry);
+        LOG_ERROR("scripts", "NPCBotsDump::VerifyWriteData creature {} is not found in `creature` table!", entry);
         return BOT_DATA_INCOMPLETE;
     }
-    if (result->GetRowCount() > 1)
+    if (itr->second.size() > 1)
     {
-        LOG_ERROR("scripts", "NPCBotsDump::AppendBotCreatureData creature {} is spawned more that once!", entry);
+        LOG_ERROR("scripts", "NPCBotsDump::VerifyWriteData creature {} is spawned more that once!", entry);
         return BOT_DATA_INCOMPLETE;
     }
 
     return BOT_DATA_VALID;
 }
 
-template<typename T>
-inline void AppendEscapedValue(std::ostringstream& ss, T const& val, bool end = false)
+void NPCBotsDump::WriteBotEquipsData(BotDumpWriter& writer, std::set<uint32> const& entries) const
 {
-    ss << '\'' << val << '\'';
-    if (!end)
-        ss << ',';
-}
-inline void AppendNULL(std::ostringstream& ss, bool end = false)
-{
-    AppendEscapedValue(ss, "NULL", end);
-    //ss << "NULL";
-    //if (!end)
-    //    ss << ',';
-}
-std::string const EscapedString(char const* cstr)
-{
-    std::string s = cstr;
-    CharacterDatabase.EscapeString(s);
-    return s;
-}
-
-void NPCBotsDump::AppendBotNPCBotData(BotStringTransaction* trans, uint32 entry) const
-{
-    NpcBotData const* botData = BotDataMgr::SelectNpcBotData(entry);
-    ASSERT(botData);
-
-    std::ostringstream ss;
-    ss << "INSERT INTO " << TableImportDatas[TABLE_TYPE_CHARACTERS_NPCBOT].name << '\n'
-        << TableImportDatas[TABLE_TYPE_CHARACTERS_NPCBOT].fieldsStr << '\n';
-
-    ss << '(';
-
-    AppendEscapedValue(ss, entry);
-    AppendEscapedValue(ss, botData->owner);
-    AppendEscapedValue(ss, botData->roles);
-    AppendEscapedValue(ss, uint32(botData->spec));
-    AppendEscapedValue(ss, botData->faction);
-
-    if (botData->disabled_spells.empty())
-        AppendNULL(ss);
-    else
+    std::vector<uint32> guids;
+    for (uint32 entry : entries)
     {
-        std::ostringstream ssds;
-        for (NpcBotData::DisabledSpellsContainer::const_iterator ci = botData->disabled_spells.begin(); ci != botData->disabled_spells.end(); ++ci)
-            ssds << *ci << ' ';
-        AppendEscapedValue(ss, ssds.str());
+        NpcBotData const* botData = ASSERT_NOTNULL(BotDataMgr::SelectNpcBotData(entry));
+        for (uint8 i = BOT_SLOT_MAINHAND; i != BOT_INVENTORY_SIZE; ++i)
+            if (botData->equips[i])
+                guids.push_back(botData->equips[i]);
     }
 
-    for (uint8 i = BOT_SLOT_MAINHAND; i != BOT_INVENTORY_SIZE; ++i)
-        AppendEscapedValue(ss, botData->equips[i], i == BOT_INVENTORY_SIZE-1);
-
-    ss << ");\n";
-
-    trans->Append(ss.str());
-}
-
-void NPCBotsDump::AppendBotNPCBotTransmogData(BotStringTransaction* trans, uint32 entry) const
-{
-    NpcBotData const* botData = BotDataMgr::SelectNpcBotData(entry);
-    ASSERT(botData);
-
-    QueryResult tresult = CharacterDatabase.Query("SELECT `entry`,`slot`,`item_id`,`fake_id` FROM `characters_npcbot_transmog` WHERE entry = {}", entry);
-
-    if (!tresult)
-        return;
-
-    std::ostringstream ss;
-    ss << "INSERT INTO " << TableImportDatas[TABLE_TYPE_NPCBOT_TRANSMOG].name << '\n'
-        << TableImportDatas[TABLE_TYPE_NPCBOT_TRANSMOG].fieldsStr << '\n';
+    writer.BeginSection(TABLE_TYPE_ITEM_INSTANCE);
 
-    static const uint32 transmog_fields_count = TableImportDatas[TABLE_TYPE_NPCBOT_TRANSMOG].paramsCount;
-
-    while (true)
+    //select items by primary key in chunks instead of a query per bot
+    for (size_t begin = 0; begin < guids.size(); begin += DumpInsertBatchRows)
     {
-        Field* fields = tresult->Fetch();
+        std::ostringstream ss;
+        for (size_t i = begin; i != std::min<size_t>(begin + DumpInsertBatchRows, guids.size()); ++i)
+            ss << (i == begin ? "" : ",") << guids[i];
 
-        ss << '(';
+        //         0            1                2      3         4        5      6             7                 8           9           10    11    12         13
+        QueryResult iiresult = CharacterDatabase.Query("SELECT creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, guid, itemEntry, owner_guid "
+            "FROM item_instance WHERE guid IN ({})", ss.str());
 
-        for (uint8 i = 0; i != transmog_fields_count; ++i)
-        {
-            bool end = i == transmog_fields_count - 1;
-            switch (i)
-            {
-                case 1:  //slot
-                    AppendEscapedValue(ss, uint32(fields[i].Get<uint8>()), end);
-                    break;
-                default:
-                    AppendEscapedValue(ss,        fields[i].Get<uint32>(), end);
-                    break;
-            }
-        }
+        //all zeros? or maybe broken entry
+        if (!iiresult)
+            continue;
 
-        if (tresult->NextRow())
-            ss << "),\n";
-        else
+        do
         {
-            ss << ");\n";
-            break;
-        }
+            Field* fields = iiresult->Fetch();
+            writer << fields[0].Get<uint32>() << fields[1].Get<uint32>() << fields[2].Get<uint32>() << fields[3].Get<uint32>();
+            writer.String(fields[4].Get<std::string>());
+            writer << fields[5].Get<uint32>();
+            writer.String(fields[6].Get<std::string>());
+            writer << int32(fields[7].Get<int16>()) << uint32(fields[8].Get<uint16>()) << fields[9].Get<uint32>();
+            writer.String(fields[10].Get<std::string>());
+            writer << fields[11].Get<uint32>() << fields[12].Get<uint32>() << fields[13].Get<uint32>();
+            writer.EndRow();
+        } while (iiresult->NextRow());
     }
-
-    trans->Append(ss.str());
 }
 
-void NPCBotsDump::AppendBotEquipsData(BotStringTransaction* trans, uint32 entry) const
+void NPCBotsDump::WriteBotNPCBotData(BotDumpWriter& writer, std::set<uint32> const& entries) const
 {
-    NpcBotData const* botData = BotDataMgr::SelectNpcBotData(entry);
-    ASSERT(botData);
-
-    EquipmentInfo const* deinfo = BotDataMgr::GetBotEquipmentInfo(entry);
-    ASSERT(deinfo);
-
-    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_NPCBOT_EQUIP_BY_ITEM_INSTANCE);
-    //        0            1                2      3         4        5      6             7                 8           9           10    11    12         13
-    //"SELECT creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, guid, itemEntry, owner_guid "
-    //  "FROM item_instance WHERE guid IN (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", CONNECTION_SYNCH
-
-    for (uint8 i = 0; i != BOT_INVENTORY_SIZE; ++i)
-        stmt->SetData(i, botData->equips[i]);
-
-    PreparedQueryResult iiresult = CharacterDatabase.Query(stmt);
-
-    //all zeros? or maybe broken entry
-    if (!iiresult)
-        return;
-
-    std::ostringstream ss;
-    ss << "INSERT INTO " << TableImportDatas[TABLE_TYPE_ITEM_INSTANCE].name << '\n'
-        << TableImportDatas[TABLE_TYPE_ITEM_INSTANCE].fieldsStr << '\n';
+    writer.BeginSection(TABLE_TYPE_CHARACTERS_NPCBOT);
 
-    static const uint32 item_instance_fields_count = TableImportDatas[TABLE_TYPE_ITEM_INSTANCE].paramsCount;
-
-    while (true)
+    for (uint32 entry : entries)
     {
-        Field* fields = iiresult->Fetch();
+        NpcBotData const* botData = ASSERT_NOTNULL(BotDataMgr::SelectNpcBotData(entry));
 
-        ss << '(';
+        writer << entry << botData->owner << botData->roles << uint32(botData->spec) << botData->faction;
 
-        for (uint8 i = 0; i != item_instance_fields_count; ++i)
-        {
-            bool end = i == item_instance_fields_count-1;
-            switch (i)
-            {
-                case 4:  //charges
-                case 6:  //enchantments
-                case 10: //text
-                {
-                    std::string cstr = fields[i].Get<std::string>();
-                    if (cstr.empty())
-                        AppendNULL(ss, end);
-                    else
-                        AppendEscapedValue(ss, EscapedString(cstr.c_str()), end);
-                    break;
-                }
-                case 7:  //randomPropertyId
-                    AppendEscapedValue(ss,      int32(fields[i].Get<int16>()),   end);
-                    break;
-                case 8:  //durability
-                    AppendEscapedValue(ss,     uint32(fields[i].Get<uint16>()),  end);
-                    break;
-                default:
-                    AppendEscapedValue(ss,            fields[i].Get<uint32>(),   end);
-                    break;
-            }
-        }
+        std::ostringstream ssds;
+        for (NpcBotData::DisabledSpellsContainer::const_iterator ci = botData->disabled_spells.begin(); ci != botData->disabled_spells.end(); ++ci)
+            ssds << *ci << ' ';
+        writer.String(ssds.str());
 
-        if (iiresult->NextRow())
-            ss << "),\n";
-        else
-        {
-            ss << ");\n";
-            break;
-        }
-    }
+        for (uint8 i = BOT_SLOT_MAINHAND; i != BOT_INVENTORY_SIZE; ++i)
+            writer << botData->equips[i];
 
-    trans->Append(ss.str());
+        writer.EndRow();
+    }
 }
 
-void NPCBotsDump::AppendBotCreatureData(BotStringTransaction* trans, uint32 entry) const
+void NPCBotsDump::WriteBotNPCBotTransmogData(BotDumpWriter& writer, std::set<uint32> const& entries) const
 {
-    QueryResult cresult = WorldDatabase.Query("SELECT `guid`,`id1`,`map`,`spawnMask`,`phaseMask`,`position_x`,`position_y`,`position_z`,`orientation`,`curhealth`,`curmana` FROM `creature` WHERE id1 = {}", entry);
-
-    ASSERT(cresult);
+    writer.BeginSection(TABLE_TYPE_NPCBOT_TRANSMOG);
 
-    std::ostringstream ss;
-    ss << "INSERT INTO " << TableImportDatas[TABLE_TYPE_CREATURE].name << '\n'
-        << TableImportDatas[TABLE_TYPE_CREATURE].fieldsStr << '\n';
+    QueryResult tresult = CharacterDatabase.Query("SELECT `entry`,`slot`,`item_id`,`fake_id` FROM `characters_npcbot_transmog`");
+    if (!tresult)
+        return;
 
-    ss << '(';
+    do
+    {
+        Field* fields = tresult->Fetch();
+        if (entries.find(fields[0].Get<uint32>()) == entries.cend())
+            continue;
 
-    static const uint32 creature_fields_count = TableImportDatas[TABLE_TYPE_CREATURE].paramsCount;
+        writer << fields[0].Get<uint32>() << uint32(fields[1].Get<uint8>()) << fields[2].Get<uint32>() << fields[3].Get<uint32>();
+        writer.EndRow();
+    } while (tresult->NextRow());
+}
 
-    Field* fields = cresult->Fetch();
+void NPCBotsDump::WriteBotCreatureData(BotDumpWriter& writer, std::set<uint32> const& entries, std::unordered_map<uint32, std::vector<BotDumpCreatureRow>> const& spawns) const
+{
+    writer.BeginSection(TABLE_TYPE_CREATURE);
 
-    for (uint8 i = 0; i != creature_fields_count; ++i)
+    for (uint32 entry : entries)
     {
-        bool end = i == creature_fields_count-1;
-        switch (i)
-        {
-            case 5:  //position_x
-            case 6:  //position_y
-            case 7:  //position_z
-            case 8:  //orientation
-                ss.setf(std::ios_base::fixed);
-                ss.precision(6);
-                AppendEscapedValue(ss,            fields[i].Get<float>(),    end);
-                break;
-            case 3:  //spawnMask
-                AppendEscapedValue(ss,     uint32(fields[i].Get<uint8>()),   end);
-                break;
-            case 2:  //map
-                AppendEscapedValue(ss,     uint32(fields[i].Get<uint16>()),  end);
-                break;
-            default:
-                AppendEscapedValue(ss,            fields[i].Get<uint32>(),   end);
-                break;
-        }
+        BotDumpCreatureRow const& row = spawns.at(entry).front();
+        writer << row.guid << entry << row.map << row.spawnMask << row.phaseMask << row.x << row.y << row.z << row.o << row.curhealth << row.curmana;
+        writer.EndRow();
     }
-
-    ss << ");\n";
-
-    trans->Append(ss.str());
 }
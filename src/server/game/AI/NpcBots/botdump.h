@@ -4,7 +4,10 @@
 #include "Define.h"
 
 #include <fstream>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 enum BotDataDumpResult
 {
@@ -27,7 +30,16 @@ enum BotDataVerificationResult
     BOT_DATA_INCOMPLETE
 };
 
-class BotStringTransaction;
+struct BotDataDumpStats
+{
+    uint32 bots = 0;
+    uint32 rows = 0;
+    uint64 bytes = 0;
+    uint32 timeMs = 0;
+};
+
+struct BotDumpCreatureRow;
+class BotDumpWriter;
 
 class NPCBotsDump
 {
@@ -37,15 +49,19 @@ class NPCBotsDump
         BotDataDumpResult Write(std::string const& file);
         BotDataDumpResult Load(std::string const& file);
 
+        BotDataDumpStats const& GetStats() const { return _stats; }
+
     private:
-        bool GetDump(std::string& dump);
-        BotDataVerificationResult VerifyWriteData(uint32 entry) const;
-        void AppendBotNPCBotData(BotStringTransaction* trans, uint32 entry) const;
-        void AppendBotNPCBotTransmogData(BotStringTransaction* trans, uint32 entry) const;
-        void AppendBotEquipsData(BotStringTransaction* trans, uint32 entry) const;
-        void AppendBotCreatureData(BotStringTransaction* trans, uint32 entry) const;
+        BotDataVerificationResult VerifyWriteData(uint32 entry, std::unordered_map<uint32, std::vector<BotDumpCreatureRow>> const& spawns) const;
+        void WriteBotEquipsData(BotDumpWriter& writer, std::set<uint32> const& entries) const;
+        void WriteBotNPCBotData(BotDumpWriter& writer, std::set<uint32> const& entries) const;
+        void WriteBotNPCBotTransmogData(BotDumpWriter& writer, std::set<uint32> const& entries) const;
+        void WriteBotCreatureData(BotDumpWriter& writer, std::set<uint32> const& entries, std::unordered_map<uint32, std::vector<BotDumpCreatureRow>> const& spawns) const;
 
         BotDataDumpResult LoadDump(std::ifstream& input);
+        BotDataDumpResult LoadStreamDump(std::ifstream& input);
+
+        BotDataDumpStats _stats;
 };
 
 #endif
@@ -0,0 +1,130 @@
+#include "botgridcache.h"
+#include "CellImpl.h"
+#include "Creature.h"
+#include "GameTime.h"
+#include "Map.h"
+#include "Player.h"
+
+#include <unordered_map>
+
+/*
+Name: botgridcache
+%Complete: 100
+Comment: Shared per-tick unit neighborhood snapshot for NPCBot grid searches
+*/
+
+#ifdef _MSC_VER
+# pragma warning(push, 4)
+#endif
+
+namespace
+{
+
+struct BotGridCellCollector
+{
+    std::vector<Unit*>& i_units;
+
+    explicit BotGridCellCollector(std::vector<Unit*>& units) : i_units(units) { }
+
+    void Visit(PlayerMapType& m)
+    {
+        for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            i_units.push_back(itr->GetSource());
+    }
+    void Visit(CreatureMapType& m)
+    {
+        for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            i_units.push_back(itr->GetSource());
+    }
+
+    template<class NOT_INTERESTED> void Visit(GridRefMgr<NOT_INTERESTED>&) { }
+};
+
+//One snapshot per map update thread, see threading note in botcommon.h
+struct BotGridSnapshot
+{
+    Map const* map = nullptr;
+    uint32 instanceId = 0;
+    Milliseconds tick = Milliseconds::zero();
+    std::unordered_map<uint32 /*cellId*/, uint32 /*poolIndex*/> cells;
+    //cell vectors are kept between ticks to avoid reallocation
+    std::vector<std::vector<Unit*>> pool;
+    uint32 used = 0;
+
+    void Reset(Map const* newMap, Milliseconds newTick)
+    {
+        map = newMap;
+        instanceId = newMap->GetInstanceId();
+        tick = newTick;
+        cells.clear();
+        used = 0;
+    }
+
+    std::vector<Unit*> const& GetCellUnits(Map* cellMap, CellCoord const& coord)
+    {
+        auto [itr, inserted] = cells.try_emplace(coord.GetId(), used);
+        if (!inserted)
+            return pool[itr->second];
+
+        if (used == pool.size())
+            pool.emplace_back();
+
+        std::vector<Unit*>& units = pool[used++];
+        units.clear();
+
+        Cell cell(coord);
+        cell.SetNoCreate();
+        BotGridCellCollector collector(units);
+        TypeContainerVisitor<BotGridCellCollector, WorldTypeMapContainer> wvisitor(collector);
+        TypeContainerVisitor<BotGridCellCollector, GridTypeMapContainer> gvisitor(collector);
+        cellMap->Visit(cell, wvisitor);
+        cellMap->Visit(cell, gvisitor);
+
+        return units;
+    }
+};
+
+thread_local BotGridSnapshot _gridSnapshot;
+
+}
+
+void BotGridCache::GetUnitsInRange(WorldObject const* center, float radius, std::vector<Unit*>& units)
+{
+    CellCoord p(Acore::ComputeCellCoord(center->GetPositionX(), center->GetPositionY()));
+    if (!p.IsCoordValid())
+        return;
+
+    Map* map = center->GetMap();
+    Milliseconds tick = GameTime::GetGameTimeMS();
+    BotGridSnapshot& snapshot = _gridSnapshot;
+    if (snapshot.map != map || snapshot.instanceId != map->GetInstanceId() || snapshot.tick != tick)
+        snapshot.Reset(map, tick);
+
+    //same as Cell::Visit: increase search radius by object's radius
+    radius += center->GetCombatReach();
+    if (radius > SIZE_OF_GRIDS)
+        radius = SIZE_OF_GRIDS;
+
+    uint32 phaseMask = center->GetPhaseMask();
+    CellArea area = Cell::CalculateCellArea(center->GetPositionX(), center->GetPositionY(), std::max<float>(radius, 0.0f));
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            CellCoord cellCoord(x, y);
+            if (!cellCoord.IsCoordValid())
+                continue;
+
+            for (Unit* unit : snapshot.GetCellUnits(map, cellCoord))
+            {
+                //might have left the map since the cell was collected
+                if (unit->IsInWorld() && unit->FindMap() == map && unit->InSamePhase(phaseMask))
+                    units.push_back(unit);
+            }
+        }
+    }
+}
+
+#ifdef _MSC_VER
+# pragma warning(pop)
+#endif
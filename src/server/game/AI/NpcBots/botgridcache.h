@@ -0,0 +1,30 @@
+#ifndef _BOT_GRIDCACHE_H
+#define _BOT_GRIDCACHE_H
+
+#include "Define.h"
+
+#include <vector>
+
+class Unit;
+class WorldObject;
+
+/*
+Per-map, per-tick snapshot of units bucketed by grid cell.
+Cells are collected on first request during a map update and then shared by all bots
+updated by the same thread, so N bots searching the same area only visit the grid once.
+Snapshot is invalidated on next world tick (game time change) or when map changes.
+Units added to a cell after it was collected are picked up on next tick (same as deferred grid relocation)
+*/
+class BotGridCache
+{
+    public:
+        //Appends all units (players and creatures) from cells within radius of center in center's phase
+        //No distance check is done here, caller is expected to apply its own unit check
+        static void GetUnitsInRange(WorldObject const* center, float radius, std::vector<Unit*>& units);
+
+    private:
+        BotGridCache() {}
+        BotGridCache(BotGridCache const&);
+};
+
+#endif
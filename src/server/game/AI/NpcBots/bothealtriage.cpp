@@ -0,0 +1,117 @@
+#include "bothealtriage.h"
+#include "botcommon.h"
+#include "GameTime.h"
+#include "Map.h"
+#include "Spell.h"
+#include "SpellInfo.h"
+#include "Unit.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+/*
+Name: bothealtriage
+%Complete: 100
+Comment: Shared per-group heal priority queue for NPCBot healers
+*/
+
+#ifdef _MSC_VER
+# pragma warning(push, 4)
+#endif
+
+namespace
+{
+
+//One set of queues per map update thread, bots of a group are always updated by the same thread (see botcommon.h)
+struct BotHealTriageSnapshot
+{
+    Map const* map = nullptr;
+    uint32 instanceId = 0;
+    Milliseconds tick = Milliseconds::zero();
+    //queues are kept between ticks to avoid reallocation
+    std::unordered_map<uint64 /*groupKey*/, BotHealQueue> queues;
+};
+
+thread_local BotHealTriageSnapshot _healTriageSnapshot;
+
+}
+
+void BotHealQueue::Reset()
+{
+    _candidates.clear();
+    _healers.clear();
+    _built = false;
+}
+
+void BotHealQueue::AddCandidate(Unit* unit, uint32 dpsTaken, bool pointed)
+{
+    uint32 priority = (unit->GetMaxHealth() - unit->GetHealth()) + dpsTaken * BOT_HEAL_TRIAGE_LOOKAHEAD / IN_MILLISECONDS;
+    _candidates.push_back({ unit, priority, 0, pointed });
+}
+
+void BotHealQueue::AddHealer(Unit const* healer)
+{
+    if (healer->HasUnitState(UNIT_STATE_CASTING))
+        _healers.push_back(healer);
+}
+
+void BotHealQueue::Build()
+{
+    //same unit may be added more than once (pointed target, vehicle), it is only pointed if never added otherwise
+    std::sort(_candidates.begin(), _candidates.end(), [](Candidate const& a, Candidate const& b) { return a.unit < b.unit; });
+    std::size_t count = 0;
+    for (std::size_t i = 0; i != _candidates.size(); ++i)
+    {
+        if (count && _candidates[count - 1].unit == _candidates[i].unit)
+            _candidates[count - 1].pointed &= _candidates[i].pointed;
+        else
+            _candidates[count++] = _candidates[i];
+    }
+    _candidates.resize(count);
+
+    for (Unit const* healer : _healers)
+    {
+        Spell const* spell = healer->GetCurrentSpell(CURRENT_GENERIC_SPELL);
+        if (!spell || !spell->GetSpellInfo()->HasEffect(SPELL_EFFECT_HEAL))
+            continue;
+
+        ObjectGuid targetGuid = spell->m_targets.GetUnitTargetGUID();
+        for (Candidate& candidate : _candidates)
+        {
+            if (candidate.unit->GetGUID() == targetGuid)
+            {
+                ++candidate.claims;
+                break;
+            }
+        }
+    }
+
+    std::stable_sort(_candidates.begin(), _candidates.end(), [](Candidate const& a, Candidate const& b) { return a.priority > b.priority; });
+    _healers.clear();
+    _built = true;
+}
+
+BotHealQueue& BotHealTriage::GetQueue(Map const* map, uint64 groupKey)
+{
+    BotHealTriageSnapshot& snapshot = _healTriageSnapshot;
+    Milliseconds tick = GameTime::GetGameTimeMS();
+    if (snapshot.map != map || snapshot.instanceId != map->GetInstanceId())
+    {
+        snapshot.queues.clear();
+        snapshot.map = map;
+        snapshot.instanceId = map->GetInstanceId();
+        snapshot.tick = tick;
+    }
+    else if (snapshot.tick != tick)
+    {
+        for (auto& p : snapshot.queues)
+            p.second.Reset();
+        snapshot.tick = tick;
+    }
+
+    return snapshot.queues[groupKey];
+}
+
+#ifdef _MSC_VER
+# pragma warning(pop)
+#endif
@@ -0,0 +1,87 @@
+#ifndef _BOT_HEALTRIAGE_H
+#define _BOT_HEALTRIAGE_H
+
+#include "Define.h"
+
+#include <vector>
+
+class Map;
+class Unit;
+
+/*
+Shared per-group heal priority queue for NPCBot healers.
+Queue is filled by the first healer of a group updated during a world tick and then shared by all
+healers of that group on the same map, so group members are only collected and evaluated once.
+Candidates are ordered by effective missing health (missing health plus damage expected to be taken
+over next BOT_HEAL_TRIAGE_LOOKAHEAD ms). Healers claim targets in that order, preferring targets
+nobody is healing yet (claimed this tick or targeted by a heal cast in progress)
+Same as BotGridCache, queues are invalidated on next world tick or when map changes
+*/
+class BotHealQueue
+{
+    friend class BotHealTriage;
+
+    public:
+        struct Candidate
+        {
+            Unit* unit;
+            uint32 priority;
+            uint32 claims;
+            //only added as a pointed heal target, healer's master related checks are done on claim
+            bool pointed;
+        };
+
+        bool IsBuilt() const { return _built; }
+
+        //Filling, queue is unusable until Build() is called
+        void AddCandidate(Unit* unit, uint32 dpsTaken, bool pointed = false);
+        //Counts heal being cast by this unit (if any) as a claim on its target
+        void AddHealer(Unit const* healer);
+        void Build();
+
+        //Tries to heal up to maxAttempts candidates in priority order, unclaimed first, returns healed unit
+        //canHeal does healer specific checks (range, pointed target checks)
+        template<class CanHeal, class HealFunc>
+        Unit* Claim(CanHeal&& canHeal, HealFunc&& heal, uint32 maxAttempts)
+        {
+            for (uint8 pass = 0; pass != 2 && maxAttempts; ++pass)
+            {
+                for (Candidate& candidate : _candidates)
+                {
+                    if ((pass == 0) != (candidate.claims == 0) || !canHeal(candidate))
+                        continue;
+
+                    if (heal(candidate.unit))
+                    {
+                        ++candidate.claims;
+                        return candidate.unit;
+                    }
+
+                    if (!--maxAttempts)
+                        break;
+                }
+            }
+
+            return nullptr;
+        }
+
+    private:
+        void Reset();
+
+        std::vector<Candidate> _candidates;
+        std::vector<Unit const*> _healers;
+        bool _built = false;
+};
+
+class BotHealTriage
+{
+    public:
+        //Returns heal queue of a group (or a master's bots if not grouped) on given map for current tick
+        static BotHealQueue& GetQueue(Map const* map, uint64 groupKey);
+
+    private:
+        BotHealTriage() {}
+        BotHealTriage(BotHealTriage const&);
+};
+
+#endif
@@ -63,10 +63,19 @@ uint8 _noDpsTargetIconFlags;
 int32 _botInfoPacketsLimit;
 uint32 _npcBotsCost;
 uint32 _npcBotUpdateDelayBase;
+uint32 _npcBotUpdateBudget;
+uint32 _npcBotUpdateMaxSlices;
+uint32 _npcBotDecisionThreads;
 uint32 _npcBotEngageDelayDPS_default;
 uint32 _npcBotEngageDelayHeal_default;
 uint32 _npcBotOwnerExpireTime;
 uint32 _desiredWanderingBotsCount;
+bool _enableWanderingBotsTravelOnlyMode;
+uint32 _wanderingBotsSpawnDelay;
+uint32 _wanderingBotsSpawnBatchSize;
+uint32 _wanderingBotsSpawnTimeBudget;
+uint32 _wanderingBotsPopulationUpdateInterval;
+uint32 _wanderingBotsPopulationMaxMoves;
 uint32 _targetBGPlayersPerTeamCount_AV;
 uint32 _targetBGPlayersPerTeamCount_WS;
 uint32 _targetBGPlayersPerTeamCount_AB;
@@ -328,6 +337,9 @@ void BotMgr::LoadConfig(bool reload)
     _botInfoPacketsLimit            = sConfigMgr->GetIntDefault("NpcBot.InfoPacketsLimit", -1);
     _npcBotsCost                    = sConfigMgr->GetIntDefault("NpcBot.Cost", 1000000);
     _npcBotUpdateDelayBase          = sConfigMgr->GetIntDefault("NpcBot.UpdateDelay.Base", 0);
+    _npcBotUpdateBudget             = sConfigMgr->GetIntDefault("NpcBot.UpdateScheduler.Budget", 0);
+    _npcBotUpdateMaxSlices          = sConfigMgr->GetIntDefault("NpcBot.UpdateScheduler.MaxSlices", 8);
+    _npcBotDecisionThreads          = sConfigMgr->GetIntDefault("NpcBot.DecisionThreads", 0);
     _npcBotEngageDelayDPS_default   = sConfigMgr->GetIntDefault("NpcBot.EngageDelay.DPS", 0);
     _npcBotEngageDelayHeal_default  = sConfigMgr->GetIntDefault("NpcBot.EngageDelay.Heal", 0);
     _npcBotOwnerExpireTime          = sConfigMgr->GetIntDefault("NpcBot.OwnershipExpireTime", 0);
@@ -369,6 +381,12 @@ void BotMgr::LoadConfig(bool reload)
     _botStatLimits_block            = sConfigMgr->GetFloatDefault("NpcBot.Stats.Limits.Block", 95.0f);
     _botStatLimits_crit             = sConfigMgr->GetFloatDefault("NpcBot.Stats.Limits.Crit", 95.0f);
     _desiredWanderingBotsCount      = sConfigMgr->GetIntDefault("NpcBot.WanderingBots.Continents.Count", 0);
+    _enableWanderingBotsTravelOnlyMode = sConfigMgr->GetBoolDefault("NpcBot.WanderingBots.TravelOnlyMode.Enable", false);
+    _wanderingBotsSpawnDelay        = sConfigMgr->GetIntDefault("NpcBot.WanderingBots.Spawn.Delay", 500);
+    _wanderingBotsSpawnBatchSize    = sConfigMgr->GetIntDefault("NpcBot.WanderingBots.Spawn.BatchSize", 10);
+    _wanderingBotsSpawnTimeBudget   = sConfigMgr->GetIntDefault("NpcBot.WanderingBots.Spawn.TimeBudget", 25);
+    _wanderingBotsPopulationUpdateInterval = sConfigMgr->GetIntDefault("NpcBot.WanderingBots.Population.UpdateInterval", 0);
+    _wanderingBotsPopulationMaxMoves = sConfigMgr->GetIntDefault("NpcBot.WanderingBots.Population.MaxMoves", 10);
     _enableWanderingBotsBG          = sConfigMgr->GetBoolDefault("NpcBot.WanderingBots.BG.Enable", false);
     _enableConfigLevelCapBG         = sConfigMgr->GetBoolDefault("NpcBot.WanderingBots.BG.CapLevel", false);
     _targetBGPlayersPerTeamCount_AV = sConfigMgr->GetIntDefault("NpcBot.WanderingBots.BG.TargetTeamPlayersCount.AV", 0);
@@ -467,6 +485,8 @@ void BotMgr::LoadConfig(bool reload)
     RoundToInterval(_mult_dmg_seawitch, 0.1f, 10.f);
     RoundToInterval(_mult_dmg_cryptlord, 0.1f, 10.f);
     RoundToInterval(_bothk_rate_honor, 0.1f, 10.f);
+    _wanderingBotsSpawnBatchSize = std::max<uint32>(_wanderingBotsSpawnBatchSize, 1);
+    _npcBotUpdateMaxSlices = std::max<uint32>(_npcBotUpdateMaxSlices, 1);
 }
 
 void BotMgr::ResolveConfigConflicts()
@@ -762,6 +782,18 @@ uint32 BotMgr::GetBaseUpdateDelay()
 {
     return _npcBotUpdateDelayBase;
 }
+uint32 BotMgr::GetBotUpdateBudget()
+{
+    return _npcBotUpdateBudget;
+}
+uint32 BotMgr::GetBotUpdateMaxSlices()
+{
+    return _npcBotUpdateMaxSlices;
+}
+uint32 BotMgr::GetBotDecisionThreads()
+{
+    return _npcBotDecisionThreads;
+}
 uint32 BotMgr::GetOwnershipExpireTime()
 {
     return _npcBotOwnerExpireTime;
@@ -770,6 +802,30 @@ uint32 BotMgr::GetDesiredWanderingBotsCount()
 {
     return _desiredWanderingBotsCount;
 }
+bool BotMgr::IsWanderingBotsTravelOnlyModeEnabled()
+{
+    return _enableWanderingBotsTravelOnlyMode;
+}
+uint32 BotMgr::GetWanderingBotsSpawnDelay()
+{
+    return _wanderingBotsSpawnDelay;
+}
+uint32 BotMgr::GetWanderingBotsSpawnBatchSize()
+{
+    return _wanderingBotsSpawnBatchSize;
+}
+uint32 BotMgr::GetWanderingBotsSpawnTimeBudget()
+{
+    return _wanderingBotsSpawnTimeBudget;
+}
+uint32 BotMgr::GetWanderingBotsPopulationUpdateInterval()
+{
+    return _wanderingBotsPopulationUpdateInterval;
+}
+uint32 BotMgr::GetWanderingBotsPopulationMaxMoves()
+{
+    return _wanderingBotsPopulationMaxMoves;
+}
 uint32 BotMgr::GetBGTargetTeamPlayersCount(BattlegroundTypeId bgTypeId)
 {
     switch (bgTypeId)
@@ -2561,6 +2617,18 @@ void BotMgr::OnBotDispelDealt(Unit* dispeller, Unit* dispelled, uint8 num)
     dispeller->ToCreature()->GetBotAI()->OnBotDispelDealt(dispelled, num);
 }
 
+void BotMgr::OnBotAuraApplied(Unit const* caster, Unit const* target, uint32 spellId)
+{
+    if (bot_ai* ai = caster->ToCreature()->GetBotAI())
+        ai->OnBotAuraApplied(target, spellId);
+}
+
+void BotMgr::OnBotAuraRemoved(Unit const* caster, Unit const* target, uint32 spellId)
+{
+    if (bot_ai* ai = caster->ToCreature()->GetBotAI())
+        ai->OnBotAuraRemoved(target, spellId);
+}
+
 void BotMgr::OnBotEnterVehicle(Creature const* passenger, Vehicle const* vehicle)
 {
     passenger->GetBotAI()->OnBotEnterVehicle(vehicle);
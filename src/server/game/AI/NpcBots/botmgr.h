@@ -123,8 +123,17 @@ class AC_GAME_API BotMgr
         static uint8 GetRangedDPSTargetIconFlags();
         static uint8 GetNoDPSTargetIconFlags();
         static uint32 GetBaseUpdateDelay();
+        static uint32 GetBotUpdateBudget();
+        static uint32 GetBotUpdateMaxSlices();
+        static uint32 GetBotDecisionThreads();
         static uint32 GetOwnershipExpireTime();
         static uint32 GetDesiredWanderingBotsCount();
+        static bool IsWanderingBotsTravelOnlyModeEnabled();
+        static uint32 GetWanderingBotsSpawnDelay();
+        static uint32 GetWanderingBotsSpawnBatchSize();
+        static uint32 GetWanderingBotsSpawnTimeBudget();
+        static uint32 GetWanderingBotsPopulationUpdateInterval();
+        static uint32 GetWanderingBotsPopulationMaxMoves();
         static uint32 GetBGTargetTeamPlayersCount(BattlegroundTypeId bgTypeId);
         static float GetBotHKHonorRate();
         static float GetBotStatLimitDodge();
@@ -160,6 +169,8 @@ class AC_GAME_API BotMgr
         static void OnBotDamageTaken(Unit* attacker, Unit* victim, uint32 damage, CleanDamage const* cleanDamage, DamageEffectType damagetype, SpellInfo const* spellInfo);
         static void OnBotDamageDealt(Unit* attacker, Unit* victim, uint32 damage, CleanDamage const* cleanDamage, DamageEffectType damagetype, SpellInfo const* spellInfo);
         static void OnBotDispelDealt(Unit* dispeller, Unit* dispelled, uint8 num);
+        static void OnBotAuraApplied(Unit const* caster, Unit const* target, uint32 spellId);
+        static void OnBotAuraRemoved(Unit const* caster, Unit const* target, uint32 spellId);
         static void OnBotEnterVehicle(Creature const* passenger, Vehicle const* vehicle);
         static void OnBotExitVehicle(Creature const* passenger, Vehicle const* vehicle);
         static void OnBotOwnerEnterVehicle(Player const* passenger, Vehicle const* vehicle);
@@ -0,0 +1,159 @@
+#include "bot_ai.h"
+#include "botmgr.h"
+#include "botscheduler.h"
+#include "GameTime.h"
+#include "Log.h"
+#include "Map.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+/*
+Name: botscheduler
+%Complete: 100
+Comment: Per-map time budget for NPCBot AI updates
+*/
+
+#ifdef _MSC_VER
+# pragma warning(push, 4)
+#endif
+
+namespace
+{
+
+struct BotMapSchedule
+{
+    Milliseconds tick = Milliseconds::zero();
+    uint32 tickCounter = 0;
+    uint32 spentUs = 0;
+    uint32 deferred = 0;
+    uint32 slices = 1;
+};
+
+//Schedules outlive ticks so slices can adapt and are erased when map is unloaded
+//Container has its own lock, schedule is shared by continent regions and used under MapRegionGuard (see botcommon.h)
+std::unordered_map<uint64 /*mapId | instanceId*/, BotMapSchedule> _mapSchedules;
+std::mutex _mapSchedulesLock;
+//bumped on erase so thread caches never hand out an erased schedule
+std::atomic<uint32> _mapSchedulesGeneration{0};
+
+struct BotScheduleCache
+{
+    Map const* map = nullptr;
+    uint32 mapId = 0;
+    uint32 instanceId = 0;
+    uint32 generation = 0;
+    BotMapSchedule* schedule = nullptr;
+};
+
+thread_local BotScheduleCache _scheduleCache;
+
+uint64 GetScheduleKey(Map const* map)
+{
+    return (uint64(map->GetId()) << 32) | map->GetInstanceId();
+}
+
+BotMapSchedule& GetSchedule(Map const* map)
+{
+    BotScheduleCache& cache = _scheduleCache;
+    uint32 generation = _mapSchedulesGeneration.load();
+    if (cache.map != map || cache.mapId != map->GetId() || cache.instanceId != map->GetInstanceId() || cache.generation != generation)
+    {
+        std::lock_guard<std::mutex> lock(_mapSchedulesLock);
+        cache.map = map;
+        cache.mapId = map->GetId();
+        cache.instanceId = map->GetInstanceId();
+        cache.generation = generation;
+        cache.schedule = &_mapSchedules[GetScheduleKey(map)]; //node-based, pointer stays valid
+    }
+
+    BotMapSchedule& schedule = *cache.schedule;
+    Milliseconds tick = GameTime::GetGameTimeMS();
+    if (schedule.tick != tick)
+    {
+        //adapt slices to last tick's load
+        uint32 budget = BotMgr::GetBotUpdateBudget();
+        if (schedule.deferred && schedule.slices < BotMgr::GetBotUpdateMaxSlices())
+        {
+            ++schedule.slices;
+            LOG_DEBUG("npcbots", "BotUpdateScheduler: map {} instance {} over budget ({} us, {} bots deferred), slices {}",
+                map->GetId(), map->GetInstanceId(), schedule.spentUs, schedule.deferred, schedule.slices);
+        }
+        else if (!schedule.deferred && schedule.slices > 1 && schedule.spentUs < budget / 2)
+            --schedule.slices;
+
+        schedule.tick = tick;
+        ++schedule.tickCounter;
+        schedule.spentUs = 0;
+        schedule.deferred = 0;
+    }
+
+    return schedule;
+}
+
+}
+
+bool BotUpdateScheduler::IsEnabled()
+{
+    return BotMgr::GetBotUpdateBudget() != 0;
+}
+
+bool BotUpdateScheduler::Admit(Creature const* bot, bool priority)
+{
+    if (!IsEnabled())
+        return true;
+
+    //continent regions share the schedule
+    MapRegionGuard guard(bot->GetMap());
+    BotMapSchedule& schedule = GetSchedule(bot->GetMap());
+    if (priority)
+        return true;
+
+    //round-robin: only one slice of low priority bots is eligible each tick
+    if (schedule.slices > 1 && (bot->GetEntry() + schedule.tickCounter) % schedule.slices != 0)
+        return false;
+
+    if (schedule.spentUs >= BotMgr::GetBotUpdateBudget())
+    {
+        ++schedule.deferred;
+        return false;
+    }
+
+    return true;
+}
+
+void BotUpdateScheduler::OnUpdated(Creature const* bot, uint32 costUs)
+{
+    if (!IsEnabled())
+        return;
+
+    MapRegionGuard guard(bot->GetMap());
+    BotMapSchedule& schedule = GetSchedule(bot->GetMap());
+    schedule.spentUs += costUs;
+}
+
+void BotUpdateScheduler::OnMapUnload(Map const* map)
+{
+    std::lock_guard<std::mutex> lock(_mapSchedulesLock);
+    if (_mapSchedules.erase(GetScheduleKey(map)))
+        ++_mapSchedulesGeneration;
+}
+
+BotUpdateCostTimer::BotUpdateCostTimer(bot_ai* ai) : _ai(ai)
+{
+    if (_ai)
+        _start = std::chrono::steady_clock::now();
+}
+
+BotUpdateCostTimer::~BotUpdateCostTimer()
+{
+    if (!_ai || !_ai->IsUpdateAdmitted())
+        return;
+
+    _ai->OnUpdateCostMeasured(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count()));
+}
+
+#ifdef _MSC_VER
+# pragma warning(pop)
+#endif
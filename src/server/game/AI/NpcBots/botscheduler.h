@@ -0,0 +1,51 @@
+#ifndef _BOT_SCHEDULER_H
+#define _BOT_SCHEDULER_H
+
+#include "Define.h"
+
+#include <chrono>
+
+class Creature;
+class Map;
+class bot_ai;
+
+/*
+Per-map time budget for NPCBot AI updates.
+Each map gets NpcBot.UpdateScheduler.Budget microseconds per world tick for bot AI updates.
+Priority bots (owned, in combat, in battleground) are always updated but their cost is still counted.
+Low priority bots (idle free bots and wanderers) are only admitted while the map has budget left.
+When a map keeps running out of budget low priority bots are split into round-robin slices
+(up to NpcBot.UpdateScheduler.MaxSlices) so each one still gets its turn, just less often
+*/
+class BotUpdateScheduler
+{
+    public:
+        //Called by bot before doing a full AI update, returns false if update should be deferred
+        static bool Admit(Creature const* bot, bool priority);
+        //Reports measured cost of an admitted AI update
+        static void OnUpdated(Creature const* bot, uint32 costUs);
+        //Drops map's schedule, called when map is destroyed
+        static void OnMapUnload(Map const* map);
+
+        static bool IsEnabled();
+
+    private:
+        BotUpdateScheduler() {}
+        BotUpdateScheduler(BotUpdateScheduler const&);
+};
+
+//Measures bot AI update duration and reports it to bot_ai and scheduler if update was admitted
+class BotUpdateCostTimer
+{
+    public:
+        explicit BotUpdateCostTimer(bot_ai* ai);
+        ~BotUpdateCostTimer();
+
+    private:
+        bot_ai* _ai;
+        std::chrono::steady_clock::time_point _start;
+
+        BotUpdateCostTimer(BotUpdateCostTimer const&);
+};
+
+#endif
@@ -1,8 +1,10 @@
 #include "botwanderful.h"
 #include "DBCStores.h"
+#include "GridDefines.h"
 #include "TemporarySummon.h"
 
 #include <algorithm>
+#include <deque>
 #include <iomanip>
 #include <unordered_set>
 
@@ -15,6 +17,23 @@ WanderNode::node_ltype WanderNode::ALL_WPS = {};
 WanderNode::node_mtype WanderNode::ALL_WPS_PER_MAP = {};
 WanderNode::node_mtype WanderNode::ALL_WPS_PER_ZONE = {};
 WanderNode::node_mtype WanderNode::ALL_WPS_PER_AREA = {};
+WanderNode::node_gmtype WanderNode::ALL_WPS_PER_MAP_GRID = {};
+std::atomic<uint32> WanderNode::WPS_GENERATION{0};
+std::unordered_map<uint64, WanderNode::node_dist_type> WanderNode::ROUTE_TABLES = {};
+uint32 WanderNode::ROUTE_TABLES_GENERATION = 0;
+
+constexpr float WP_GRID_CELL_SIZE = SIZE_OF_GRIDS * 0.5f;
+constexpr int32 WP_GRID_CELLS_PER_SIDE = int32(MAX_NUMBER_OF_GRIDS * 2);
+
+static int32 ComputeWPGridCoord(float c)
+{
+    return std::clamp<int32>(int32((c + MAP_HALFSIZE) / WP_GRID_CELL_SIZE), 0, WP_GRID_CELLS_PER_SIDE - 1);
+}
+
+static uint32 MakeWPGridCellId(int32 x, int32 y)
+{
+    return uint32(y * WP_GRID_CELLS_PER_SIDE + x);
+}
 
 WanderNode::mutex_type* WanderNode::GetLock()
 {
@@ -148,6 +167,92 @@ void WanderNode::DoForAllAreaWPs(uint32 areaId, node_proc_ftype_c&& func)
         DoForContainerWPs(ci->second, std::forward<node_proc_ftype_c>(func));
 }
 
+void WanderNode::DoForAllMapWPsInRange(uint32 mapId, Position const* pos, float range, node_proc_ftype_c&& func)
+{
+    lock_type lock(*GetLock());
+
+    node_gmtype::const_iterator ci = ALL_WPS_PER_MAP_GRID.find(mapId);
+    if (ci == ALL_WPS_PER_MAP_GRID.end())
+        return;
+
+    node_grid_type const& grid = ci->second;
+    int32 lowX = std::max<int32>(ComputeWPGridCoord(pos->m_positionX - range), grid.minX);
+    int32 highX = std::min<int32>(ComputeWPGridCoord(pos->m_positionX + range), grid.maxX);
+    int32 lowY = std::max<int32>(ComputeWPGridCoord(pos->m_positionY - range), grid.minY);
+    int32 highY = std::min<int32>(ComputeWPGridCoord(pos->m_positionY + range), grid.maxY);
+    for (int32 x = lowX; x <= highX; ++x)
+    {
+        for (int32 y = lowY; y <= highY; ++y)
+        {
+            auto cci = grid.cells.find(MakeWPGridCellId(x, y));
+            if (cci == grid.cells.cend())
+                continue;
+            for (WanderNode const* wp : cci->second)
+                if (pos->GetExactDist2d(wp) < range)
+                    func(wp);
+        }
+    }
+}
+
+WanderNode const* WanderNode::FindClosestMapWP(uint32 mapId, Position const* pos, node_check_ftype_c const& pred)
+{
+    lock_type lock(*GetLock());
+
+    node_gmtype::const_iterator ci = ALL_WPS_PER_MAP_GRID.find(mapId);
+    if (ci == ALL_WPS_PER_MAP_GRID.end())
+        return nullptr;
+
+    node_grid_type const& grid = ci->second;
+    WanderNode const* closestNode = nullptr;
+    float mindist = 0.0f;
+
+    auto check_cell = [&](int32 x, int32 y) {
+        if (x < grid.minX || x > grid.maxX || y < grid.minY || y > grid.maxY)
+            return;
+        auto cci = grid.cells.find(MakeWPGridCellId(x, y));
+        if (cci == grid.cells.cend())
+            return;
+        for (WanderNode const* wp : cci->second)
+        {
+            float dist = pos->GetExactDist2d(wp);
+            if ((!closestNode || dist < mindist) && pred(wp))
+            {
+                mindist = dist;
+                closestNode = wp;
+            }
+        }
+    };
+
+    //expand square rings around pos cell, every node in ring k is at least (k-1) cells away
+    int32 cx = ComputeWPGridCoord(pos->m_positionX);
+    int32 cy = ComputeWPGridCoord(pos->m_positionY);
+    for (int32 k = 0; ; ++k)
+    {
+        if (closestNode && float(k - 1) * WP_GRID_CELL_SIZE >= mindist)
+            break;
+        if (cx - k < grid.minX && cx + k > grid.maxX && cy - k < grid.minY && cy + k > grid.maxY)
+            break;
+
+        if (k == 0)
+        {
+            check_cell(cx, cy);
+            continue;
+        }
+        for (int32 x = cx - k; x <= cx + k; ++x)
+        {
+            check_cell(x, cy - k);
+            check_cell(x, cy + k);
+        }
+        for (int32 y = cy - k + 1; y <= cy + k - 1; ++y)
+        {
+            check_cell(cx - k, y);
+            check_cell(cx + k, y);
+        }
+    }
+
+    return closestNode;
+}
+
 size_t WanderNode::GetAllWPsCount()
 {
     lock_type lock(*GetLock());
@@ -170,6 +275,49 @@ size_t WanderNode::GetWPMapsCount()
     return ALL_WPS_PER_MAP.size();
 }
 
+uint32 WanderNode::GetWPsGeneration()
+{
+    return WPS_GENERATION.load();
+}
+
+void WanderNode::AddToGrid(WanderNode* wp)
+{
+    int32 x = ComputeWPGridCoord(wp->m_positionX);
+    int32 y = ComputeWPGridCoord(wp->m_positionY);
+
+    auto [itr, inserted] = ALL_WPS_PER_MAP_GRID.try_emplace(wp->_mapId);
+    node_grid_type& grid = itr->second;
+    if (inserted)
+    {
+        grid.minX = grid.maxX = x;
+        grid.minY = grid.maxY = y;
+    }
+    else
+    {
+        grid.minX = std::min<int32>(grid.minX, x);
+        grid.maxX = std::max<int32>(grid.maxX, x);
+        grid.minY = std::min<int32>(grid.minY, y);
+        grid.maxY = std::max<int32>(grid.maxY, y);
+    }
+    grid.cells[MakeWPGridCellId(x, y)].push_back(wp);
+}
+
+void WanderNode::RemoveFromGrid(WanderNode* wp)
+{
+    //bounds are not shrunk, they are only used to limit searches
+    node_gmtype::iterator itr = ALL_WPS_PER_MAP_GRID.find(wp->_mapId);
+    if (itr != ALL_WPS_PER_MAP_GRID.end())
+    {
+        auto cci = itr->second.cells.find(MakeWPGridCellId(ComputeWPGridCoord(wp->m_positionX), ComputeWPGridCoord(wp->m_positionY)));
+        if (cci != itr->second.cells.end())
+        {
+            cci->second.remove(wp);
+            if (cci->second.empty())
+                itr->second.cells.erase(cci);
+        }
+    }
+}
+
 WanderNode::WanderNode(uint32 wpId, uint32 mapId, float x, float y, float z, float o, uint32 zoneId, uint32 areaId, std::string const& name)
     : Position(x, y, z, o),
     _wpId(wpId), _mapId(mapId), _zoneId(zoneId), _areaId(areaId), _name(name), _minLevel(1u), _maxLevel(DEFAULT_MAX_LEVEL), _flags(0),
@@ -185,6 +333,8 @@ WanderNode::WanderNode(uint32 wpId, uint32 mapId, float x, float y, float z, flo
     ALL_WPS_PER_MAP[_mapId].push_back(this);
     ALL_WPS_PER_ZONE[_zoneId].push_back(this);
     ALL_WPS_PER_AREA[_areaId].push_back(this);
+    AddToGrid(this);
+    ++WPS_GENERATION;
 }
 
 WanderNode::~WanderNode()
@@ -194,6 +344,8 @@ WanderNode::~WanderNode()
 
 void WanderNode::RemoveWP(WanderNode* wp)
 {
+    lock_type lock(*GetLock());
+
     while (!wp->GetLinks().empty())
         wp->UnLink(wp->GetLinks().front());
 
@@ -204,6 +356,8 @@ void WanderNode::RemoveWP(WanderNode* wp)
     ALL_WPS_PER_ZONE.at(wp->_zoneId).remove(wp);
     ALL_WPS_PER_MAP.at(wp->_mapId).remove(wp);
     ALL_WPS.remove(wp);
+    RemoveFromGrid(wp);
+    ++WPS_GENERATION;
 
     //WE LET THE NODE LEAK for threadsafety
     //delete wp
@@ -217,74 +371,122 @@ void WanderNode::RemoveAllWPs()
         RemoveWP(ALL_WPS.front());
 }
 
-WanderNode::node_ltype_c WanderNode::GetShortestPathLinks(WanderNode const* target, WanderNode::node_ltype_c const& base_links) const
+WanderNode::node_dist_type const& WanderNode::GetRouteDistances(uint32 mapId, uint64 key, node_check_ftype_c const& is_dest)
 {
-    using NodeList = WanderNode::node_ltype_c;
+    //tables are built on demand and dropped whenever nodes or links change
+    uint32 generation = WPS_GENERATION.load();
+    if (ROUTE_TABLES_GENERATION != generation)
+    {
+        ROUTE_TABLES.clear();
+        ROUTE_TABLES_GENERATION = generation;
+    }
 
-    ASSERT(std::all_of(base_links.cbegin(), base_links.cend(), [this](WanderNode const* wp) { return HasLink(wp); }));
+    auto [itr, inserted] = ROUTE_TABLES.try_emplace(key);
+    node_dist_type& dists = itr->second;
+    if (!inserted)
+        return dists;
 
-    NodeList retlist;
-    if (this == target)
-        retlist.push_back(this);
-    else
+    node_mtype::const_iterator ci = ALL_WPS_PER_MAP.find(mapId);
+    if (ci == ALL_WPS_PER_MAP.cend())
+        return dists;
+
+    //multi-source BFS from destinations over reversed links (links may be one-way)
+    std::unordered_map<WanderNode const*, node_ltype_c> rlinks;
+    std::deque<WanderNode const*> queue;
+    for (WanderNode const* wp : ci->second)
     {
-        std::list<std::pair<uint32 /*level*/, WanderNode const*>> validLinks;
-        for (WanderNode const* link : base_links)
+        for (WanderNode const* lwp : wp->GetLinks())
+            rlinks[lwp].push_back(wp);
+        if (is_dest(wp))
         {
-            if (link == target)
-            {
-                retlist.push_back(link);
-                validLinks.clear();
-                break;
-            }
-
-            std::unordered_set<WanderNode const*> checked_links;
-            checked_links.insert(this);
-            NodeList vlinks_cur;
-            NodeList clinks;
-            clinks.push_back(link);
-            for (uint32 level = 0; !clinks.empty(); ++level)
-            {
-                for (WanderNode const* wp : clinks)
-                {
-                    if (wp->HasLink(target))
-                        vlinks_cur.push_back(link);
-                }
-                if (!vlinks_cur.empty())
-                {
-                    validLinks.emplace_back(level, link);
-                    break;
-                }
-                NodeList clinks_new;
-                for (WanderNode const* wp : clinks)
-                {
-                    checked_links.insert(wp); // cut off all ways back (2-ways, circular)
-                    std::copy_if(wp->GetLinks().begin(), wp->GetLinks().end(), std::back_inserter(clinks_new), [&checked_links](WanderNode const* cwp) {
-                        return !checked_links.count(cwp);
-                    });
-                }
-                clinks = std::move(clinks_new);
-            }
+            dists[wp] = 0;
+            queue.push_back(wp);
         }
+    }
+    while (!queue.empty())
+    {
+        WanderNode const* wp = queue.front();
+        queue.pop_front();
+        uint32 dist = dists.at(wp) + 1;
+        auto rci = rlinks.find(wp);
+        if (rci == rlinks.cend())
+            continue;
+        for (WanderNode const* rwp : rci->second)
+            if (dists.try_emplace(rwp, dist).second)
+                queue.push_back(rwp);
+    }
 
-        if (!validLinks.empty())
+    return dists;
+}
+
+WanderNode::node_ltype_c WanderNode::SelectNextHops(node_dist_type const& dists, WanderNode::node_ltype_c const& base_links) const
+{
+    node_ltype_c retlist;
+    uint32 mindist = std::numeric_limits<uint32>::max();
+    for (WanderNode const* link : base_links)
+    {
+        node_dist_type::const_iterator ci = dists.find(link);
+        if (ci == dists.cend() || ci->second > mindist)
+            continue;
+        if (ci->second < mindist)
         {
-            //only choose one of the shortest routes
-            if (validLinks.size() > 1)
-            {
-                auto minlevel = std::numeric_limits<decltype(validLinks)::value_type::first_type>::max();
-                for (auto const& kv : validLinks)
-                    minlevel = std::min<decltype(minlevel)>(minlevel, kv.first);
-                validLinks.remove_if([=](decltype(validLinks)::value_type const& p) { return p.first > minlevel; });
-            }
-            for (decltype(validLinks)::value_type const& vt : validLinks)
-                retlist.emplace_back(std::move(vt.second));
+            mindist = ci->second;
+            retlist.clear();
         }
+        retlist.push_back(link);
     }
 
     return retlist;
 }
 
+WanderNode::node_ltype_c WanderNode::GetShortestPathLinks(WanderNode const* target, WanderNode::node_ltype_c const& base_links) const
+{
+    ASSERT(std::all_of(base_links.cbegin(), base_links.cend(), [this](WanderNode const* wp) { return HasLink(wp); }));
+
+    if (this == target)
+        return { this };
+
+    lock_type lock(*GetLock());
+
+    node_dist_type const& dists = GetRouteDistances(target->GetMapId(), uint64(target->GetWPId()), [target](WanderNode const* wp) {
+        return wp == target;
+    });
+    return SelectNextHops(dists, base_links);
+}
+
+WanderNode::node_ltype_c WanderNode::GetShortestPathLinks(BotWPRouteTarget target, WanderNode::node_ltype_c const& base_links) const
+{
+    static const std::array<node_check_ftype_c, AsUnderlyingType(BotWPRouteTarget::BOTWP_ROUTE_END)> route_target_preds = {
+        [](WanderNode const* wp) {
+            return wp->HasFlag(BotWPFlags::BOTWP_FLAG_BG_FLAG_DELIVER_TARGET) &&
+                (!wp->HasFlag(BotWPFlags::BOTWP_FLAG_ALLIANCE_OR_HORDE_ONLY) || wp->HasFlag(BotWPFlags::BOTWP_FLAG_ALLIANCE_ONLY));
+        },
+        [](WanderNode const* wp) {
+            return wp->HasFlag(BotWPFlags::BOTWP_FLAG_BG_FLAG_DELIVER_TARGET) &&
+                (!wp->HasFlag(BotWPFlags::BOTWP_FLAG_ALLIANCE_OR_HORDE_ONLY) || wp->HasFlag(BotWPFlags::BOTWP_FLAG_HORDE_ONLY));
+        },
+        [](WanderNode const* wp) {
+            return wp->HasFlag(BotWPFlags::BOTWP_FLAG_BG_FLAG_DELIVER_TARGET) && !wp->HasFlag(BotWPFlags::BOTWP_FLAG_ALLIANCE_OR_HORDE_ONLY);
+        }
+    };
+
+    ASSERT(target < BotWPRouteTarget::BOTWP_ROUTE_END);
+    ASSERT(std::all_of(base_links.cbegin(), base_links.cend(), [this](WanderNode const* wp) { return HasLink(wp); }));
+
+    lock_type lock(*GetLock());
+
+    //class keys never collide with node ids
+    uint64 key = (uint64(1) << 63) | (uint64(AsUnderlyingType(target)) << 32) | uint64(_mapId);
+    node_dist_type const& dists = GetRouteDistances(_mapId, key, route_target_preds[AsUnderlyingType(target)]);
+
+    //already at destination
+    node_dist_type::const_iterator ci = dists.find(this);
+    if (ci != dists.cend() && ci->second == 0)
+        return {};
+
+    return SelectNextHops(dists, base_links);
+}
+
 void WanderNode::SetCreature(Creature* creature)
 {
     if (creature != nullptr)
@@ -307,14 +509,26 @@ std::string WanderNode::FormatLinks() const
     return lss.str();
 }
 
+void WanderNode::SetPosition(Position const& pos)
+{
+    lock_type lock(*GetLock());
+
+    RemoveFromGrid(this);
+    Relocate(pos);
+    AddToGrid(this);
+    ++WPS_GENERATION;
+}
+
 void WanderNode::SetFlags(BotWPFlags flags)
 {
     _flags |= AsUnderlyingType(flags);
+    ++WPS_GENERATION;
 }
 
 void WanderNode::RemoveFlags(BotWPFlags flags)
 {
     _flags &= ~AsUnderlyingType(flags);
+    ++WPS_GENERATION;
 }
 
 bool WanderNode::HasFlag(BotWPFlags flags) const
@@ -3,6 +3,7 @@
 
 #include "Position.h"
 
+#include <atomic>
 #include <functional>
 #include <list>
 #include <shared_mutex>
@@ -36,6 +37,15 @@ enum class BotWPFlags : uint32
     BOTWP_FLAG_HORDE_BOSS_ROOM          = BOTWP_FLAG_HORDE_ONLY | BOTWP_FLAG_BG_BOSS_ROOM
 };
 
+//Destination classes with precomputed next-hop routing
+enum class BotWPRouteTarget : uint8
+{
+    BOTWP_ROUTE_FLAG_DELIVER_ALLIANCE   = 0, // BOTWP_FLAG_BG_FLAG_DELIVER_TARGET usable by alliance
+    BOTWP_ROUTE_FLAG_DELIVER_HORDE      = 1, // BOTWP_FLAG_BG_FLAG_DELIVER_TARGET usable by horde
+    BOTWP_ROUTE_FLAG_DELIVER_NEUTRAL    = 2, // BOTWP_FLAG_BG_FLAG_DELIVER_TARGET with no faction restriction
+    BOTWP_ROUTE_END
+};
+
 class WanderNode : public Position
 {
     using node_ltype = std::list<WanderNode*>;
@@ -49,10 +59,31 @@ class WanderNode : public Position
     using mutex_type = std::recursive_mutex;
     using lock_type = std::unique_lock<mutex_type>;
 
+    //uniform grid over map nodes for radius / nearest queries
+    struct node_grid_type
+    {
+        std::unordered_map<uint32 /*cellId*/, node_ltype> cells;
+        int32 minX, minY, maxX, maxY;
+    };
+    using node_gmtype = std::unordered_map<uint32 /*mapId*/, node_grid_type>;
+    //hop counts to a destination (node or class of nodes), unreachable nodes are not included
+    using node_dist_type = std::unordered_map<WanderNode const*, uint32>;
+
     static node_ltype ALL_WPS;
     static node_mtype ALL_WPS_PER_MAP;
     static node_mtype ALL_WPS_PER_ZONE;
     static node_mtype ALL_WPS_PER_AREA;
+    static node_gmtype ALL_WPS_PER_MAP_GRID;
+    //atomic: node links, flags and levels are changed without holding the lock
+    static std::atomic<uint32> WPS_GENERATION;
+    static std::unordered_map<uint64, node_dist_type> ROUTE_TABLES;
+    static uint32 ROUTE_TABLES_GENERATION;
+
+    static void AddToGrid(WanderNode* wp);
+    static void RemoveFromGrid(WanderNode* wp);
+
+    static node_dist_type const& GetRouteDistances(uint32 mapId, uint64 key, node_check_ftype_c const& is_dest);
+    node_ltype_c SelectNextHops(node_dist_type const& dists, node_ltype_c const& base_links) const;
 
     template<class T, typename = void>
     struct is_container : std::false_type {};
@@ -88,9 +119,13 @@ public:
     static void DoForAllMapWPs(uint32 mapId, node_proc_ftype_c&& func);
     static void DoForAllZoneWPs(uint32 zoneId, node_proc_ftype_c&& func);
     static void DoForAllAreaWPs(uint32 areaId, node_proc_ftype_c&& func);
+    static void DoForAllMapWPsInRange(uint32 mapId, Position const* pos, float range, node_proc_ftype_c&& func);
+    static WanderNode const* FindClosestMapWP(uint32 mapId, Position const* pos, node_check_ftype_c const& pred);
     static size_t GetAllWPsCount();
     static size_t GetMapWPsCount(uint32 mapId);
     static size_t GetWPMapsCount();
+    //changes every time a node is added, removed, moved or has its flags or levels changed
+    static uint32 GetWPsGeneration();
 
     WanderNode(uint32 wpId, uint32 mapId, float x, float y, float z, float o, uint32 zoneId, uint32 areaId, std::string const& name);
     ~WanderNode();
@@ -99,7 +134,9 @@ public:
     static void RemoveWP(WanderNode* wp);
 
     //utils
+    //Returns base links which are next hops on one of the shortest routes to target (or class of targets)
     WanderNode::node_ltype_c GetShortestPathLinks(WanderNode const* target, WanderNode::node_ltype_c const& base_links) const;
+    WanderNode::node_ltype_c GetShortestPathLinks(BotWPRouteTarget target, WanderNode::node_ltype_c const& base_links) const;
 
     //base
     void SetCreature(Creature* creature);
@@ -110,6 +147,7 @@ public:
     void Link(WanderNode* wp, bool oneway = false) {
         if (!HasLink(wp)) {
             _links.push_back(wp);
+            ++WPS_GENERATION;
             if (!oneway)
                 wp->Link(this);
         }
@@ -117,6 +155,7 @@ public:
     void UnLink(WanderNode* wp) {
         if (HasLink(wp)) {
             _links.remove(wp);
+            ++WPS_GENERATION;
             wp->UnLink(this);
         }
     }
@@ -129,6 +168,7 @@ public:
 
     void SetLevels(std::pair<uint8, uint8> levels) {
         std::tie(_minLevel, _maxLevel) = levels;
+        ++WPS_GENERATION;
     }
     inline void SetLevels(uint8 minLevel, uint8 maxLevel) {
         SetLevels(std::pair{ minLevel, maxLevel });
@@ -139,6 +179,7 @@ public:
     bool HasFlag(BotWPFlags flags) const;
 
     void SetName(std::string const& name) { _name = name; }
+    void SetPosition(Position const& pos);
 
     std::string ToString() const;
 
@@ -55,6 +55,8 @@ public:
     void RemoveFromWorld() override;
 
     void BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const override;
+    // bytes are hidden depending on owner's relation to each player
+    [[nodiscard]] bool CanShareValuesUpdate() const override { return false; }
 
     bool Create(ObjectGuid::LowType guidlow);
     bool Create(ObjectGuid::LowType guidlow, Player* owner);
@@ -62,6 +62,7 @@ CreatureMovementData::CreatureMovementData() : Ground(CreatureGroundMovementType
 //npcbot
 #include "bot_ai.h"
 #include "botmgr.h"
+#include "botscheduler.h"
 #include "bpet_ai.h"
 //end npcbot
 
@@ -854,6 +855,9 @@ void Creature::Update(uint32 diff)
             {
                 // do not allow the AI to be changed during update
                 m_AI_locked = true;
+                //npcbot: measure bot AI update cost for update scheduler
+                BotUpdateCostTimer botCostTimer(bot_AI);
+                //end npcbot
                 i_AI->UpdateAI(diff);
                 m_AI_locked = false;
             }
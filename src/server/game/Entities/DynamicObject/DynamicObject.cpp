@@ -25,6 +25,10 @@
 #include "UpdateMask.h"
 #include "World.h"
 
+//npcbot
+#include "botaoezones.h"
+//end npcbot
+
 DynamicObject::DynamicObject(bool isWorldObject) : WorldObject(isWorldObject), MovableMapObject(),
     _aura(nullptr), _removedAura(nullptr), _caster(nullptr), _duration(0), _isViewpoint(false), _updateViewerVisibilityTimer(0)
 {
@@ -68,6 +72,10 @@ void DynamicObject::AddToWorld()
         WorldObject::AddToWorld();
 
         BindToCaster();
+
+        //npcbot
+        BotAoeZoneRegistry::OnDynObjectAdded(this);
+        //end npcbot
     }
 }
 
@@ -76,6 +84,10 @@ void DynamicObject::RemoveFromWorld()
     ///- Remove the dynamicObject from the accessor and from all lists of objects in world
     if (IsInWorld())
     {
+        //npcbot
+        BotAoeZoneRegistry::OnDynObjectRemoved(this);
+        //end npcbot
+
         if (_isViewpoint)
             RemoveCasterViewpoint();
 
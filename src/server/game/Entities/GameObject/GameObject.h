@@ -125,6 +125,8 @@ public:
     ~GameObject() override;
 
     void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+    [[nodiscard]] bool IsTargetDependentUpdateField(uint16 index) const override;
+    [[nodiscard]] uint32 BuildValuesUpdateFieldForTarget(uint16 index, Player* target) const override;
 
     void AddToWorld() override;
     void RemoveFromWorld() override;
@@ -542,7 +542,7 @@ void Object::ClearUpdateMask(bool remove)
     }
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, SharedValuesUpdateCache* sharedUpdates) const
 {
     UpdateDataMapType::iterator iter = data_map.find(player);
 
@@ -553,7 +553,54 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (!sharedUpdates || !CanShareValuesUpdate())
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        return;
+    }
+
+    // update mask only depends on visibility flags, so the block is built once per visibility class
+    uint32 visibleFlag = GetValuesUpdateVisibleFlag(player);
+    for (SharedValuesUpdate const& shared : *sharedUpdates)
+    {
+        if (shared.VisibleFlag != visibleFlag)
+            continue;
+
+        std::size_t pos = iter->second.AddSharedUpdateBlock(shared.Block);
+        for (std::pair<std::size_t, uint16> const& field : shared.TargetFields)
+            iter->second.PatchUpdateBlock(pos + field.first, BuildValuesUpdateFieldForTarget(field.second, player));
+        return;
+    }
+
+    SharedValuesUpdate& shared = sharedUpdates->emplace_back();
+    shared.VisibleFlag = visibleFlag;
+    shared.Block << uint8(UPDATETYPE_VALUES);
+    shared.Block << GetPackGUID();
+    std::size_t maskPos = shared.Block.wpos();
+    BuildValuesUpdate(UPDATETYPE_VALUES, &shared.Block, player);
+
+    // every field is sent as 4 bytes, find where target dependent ones are
+    uint8 blockCount = shared.Block.read<uint8>(maskPos);
+    std::size_t fieldPos = maskPos + 1 + blockCount * sizeof(UpdateMask::ClientUpdateMaskType);
+    for (uint16 index = 0; index < m_valuesCount && index < blockCount * UpdateMask::CLIENT_UPDATE_MASK_BITS; ++index)
+    {
+        std::size_t maskPartPos = maskPos + 1 + (index / UpdateMask::CLIENT_UPDATE_MASK_BITS) * sizeof(UpdateMask::ClientUpdateMaskType);
+        if (!(shared.Block.read<UpdateMask::ClientUpdateMaskType>(maskPartPos) & (1 << (index % UpdateMask::CLIENT_UPDATE_MASK_BITS))))
+            continue;
+
+        if (IsTargetDependentUpdateField(index))
+            shared.TargetFields.emplace_back(fieldPos, index);
+
+        fieldPos += sizeof(uint32);
+    }
+
+    iter->second.AddUpdateBlock(shared.Block);
+}
+
+uint32 Object::GetValuesUpdateVisibleFlag(Player const* target) const
+{
+    uint32* flags = nullptr;
+    return GetUpdateFieldData(target, flags);
 }
 
 uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
@@ -3001,6 +3048,7 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     UpdatePlayerSet& i_playerSet;
     WorldObject& i_object;
+    SharedValuesUpdateCache i_sharedUpdates;
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d, UpdatePlayerSet& p) : i_updateDatas(d), i_playerSet(p), i_object(obj)
     {
         i_playerSet.clear();
@@ -3061,7 +3109,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (i_playerSet.find(player->GetGUID()) == i_playerSet.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, &i_sharedUpdates);
             i_playerSet.insert(player->GetGUID());
         }
     }
@@ -91,6 +91,17 @@ class MotionTransport;
 struct PositionFullTerrainStatus;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
+
+// Values update block of one object built for the first player of a visibility class and copied for the rest of them,
+// fields whose value depends on the player are overwritten at recorded offsets
+struct SharedValuesUpdate
+{
+    uint32 VisibleFlag = 0;
+    ByteBuffer Block;
+    std::vector<std::pair<std::size_t /*offset*/, uint16 /*index*/>> TargetFields;
+};
+
+typedef std::vector<SharedValuesUpdate> SharedValuesUpdateCache;
 typedef GuidUnorderedSet UpdatePlayerSet;
 
 class Object
@@ -183,7 +194,7 @@ public:
     [[nodiscard]] virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
     [[nodiscard]] virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
     virtual void BuildUpdate(UpdateDataMapType&, UpdatePlayerSet&) {}
-    void BuildFieldsUpdate(Player*, UpdateDataMapType&) const;
+    void BuildFieldsUpdate(Player*, UpdateDataMapType&, SharedValuesUpdateCache* sharedUpdates = nullptr) const;
 
     void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
     void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= ~flag; }
@@ -231,6 +242,12 @@ protected:
     void BuildMovementUpdate(ByteBuffer* data, uint16 flags) const;
     virtual void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
 
+    // Values update sharing, see SharedValuesUpdate
+    [[nodiscard]] virtual bool CanShareValuesUpdate() const { return true; }
+    [[nodiscard]] virtual uint32 GetValuesUpdateVisibleFlag(Player const* target) const;
+    [[nodiscard]] virtual bool IsTargetDependentUpdateField(uint16 /*index*/) const { return false; }
+    [[nodiscard]] virtual uint32 BuildValuesUpdateFieldForTarget(uint16 index, Player* /*target*/) const { return m_uint32Values[index]; }
+
     uint16 m_objectType;
 
     TypeID m_objectTypeId;
@@ -24,6 +24,44 @@
 #include "WorldPacket.h"
 #include "zlib.h"
 
+namespace
+{
+    // deflate state is allocated once per thread and reset between packets
+    struct UpdateCompressionStream
+    {
+        z_stream Stream;
+        int Level = -1; // not initialized
+
+        ~UpdateCompressionStream()
+        {
+            if (Level >= 0)
+                deflateEnd(&Stream);
+        }
+
+        int Reset(int level)
+        {
+            if (Level == level)
+                return deflateReset(&Stream);
+
+            if (Level >= 0)
+                deflateEnd(&Stream);
+
+            Level = -1;
+            Stream.zalloc = (alloc_func)0;
+            Stream.zfree = (free_func)0;
+            Stream.opaque = (voidpf)0;
+
+            int z_res = deflateInit(&Stream, level);
+            if (z_res == Z_OK)
+                Level = level;
+
+            return z_res;
+        }
+    };
+
+    thread_local UpdateCompressionStream _compressionStream;
+}
+
 UpdateData::UpdateData() : m_blockCount(0)
 {
     m_outOfRangeGUIDs.reserve(15);
@@ -46,16 +84,19 @@ void UpdateData::AddUpdateBlock(const UpdateData& block)
     m_blockCount += block.m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+std::size_t UpdateData::AddSharedUpdateBlock(const ByteBuffer& block)
 {
-    z_stream c_stream;
+    std::size_t pos = m_data.wpos();
+    AddUpdateBlock(block);
+    return pos;
+}
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+{
+    z_stream& c_stream = _compressionStream.Stream;
 
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld->getIntConfig(CONFIG_COMPRESSION));
+    int z_res = _compressionStream.Reset(sWorld->getIntConfig(CONFIG_COMPRESSION));
     if (z_res != Z_OK)
     {
         LOG_ERROR("entities.object", "Can't compress update packet (zlib: deflateInit) Error code: {} ({})", z_res, zError(z_res));
@@ -91,14 +132,6 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        LOG_ERROR("entities.object", "Can't compress update packet (zlib: deflateEnd) Error code: {} ({})", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
     *dst_size = c_stream.total_out;
 }
 
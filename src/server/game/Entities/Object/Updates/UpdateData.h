@@ -56,6 +56,9 @@ public:
     void AddOutOfRangeGUID(ObjectGuid guid);
     void AddUpdateBlock(const ByteBuffer& block);
     void AddUpdateBlock(const UpdateData& block);
+    // Appends a values block shared between players, returns its position so values that differ for this player can be overwritten
+    std::size_t AddSharedUpdateBlock(const ByteBuffer& block);
+    void PatchUpdateBlock(std::size_t pos, uint32 value) { m_data.put<uint32>(pos, value); }
     bool BuildPacket(WorldPacket* packet);
     [[nodiscard]] bool HasData() const { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
     void Clear();
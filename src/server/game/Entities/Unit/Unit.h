@@ -2540,6 +2540,12 @@ protected:
 
     void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
 
+    [[nodiscard]] bool CanShareValuesUpdate() const override;
+    [[nodiscard]] uint32 GetValuesUpdateVisibleFlag(Player const* target) const override;
+    [[nodiscard]] bool IsTargetDependentUpdateField(uint16 index) const override;
+    [[nodiscard]] uint32 BuildValuesUpdateFieldForTarget(uint16 index, Player* target) const override;
+    bool BuildFactionUpdateFieldForTarget(uint16 index, Player const* target, uint32& value) const;
+
     UnitAI* i_AI, *i_disabledAI;
 
     void _UpdateSpells(uint32 time);
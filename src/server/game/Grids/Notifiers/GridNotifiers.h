@@ -102,6 +102,7 @@ namespace Acore
         float i_distSq;
         TeamId teamId;
         Player const* skipped_receiver;
+        std::shared_ptr<WorldPacket const> i_sharedMessage; // copied once on first delivery, body is shared by all receivers
         MessageDistDeliverer(WorldObject const* src, WorldPacket const* msg, float dist, bool own_team_only = false, Player const* skipped = nullptr)
             : i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist)
             , teamId((own_team_only && src->GetTypeId() == TYPEID_PLAYER) ? src->ToPlayer()->GetTeamId() : TEAM_NEUTRAL)
@@ -122,7 +123,10 @@ namespace Acore
             if (!player->HaveAtClient(i_source))
                 return;
 
-            player->GetSession()->SendPacket(i_message);
+            if (!i_sharedMessage)
+                i_sharedMessage = std::make_shared<WorldPacket>(*i_message);
+
+            player->GetSession()->SendSharedPacket(i_sharedMessage);
         }
     };
 
@@ -132,6 +136,7 @@ namespace Acore
         WorldPacket* i_message;
         uint32 i_phaseMask;
         float i_distSq;
+        std::shared_ptr<WorldPacket const> i_sharedMessage;
         MessageDistDelivererToHostile(Unit* src, WorldPacket* msg, float dist)
             : i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist)
         {
@@ -147,7 +152,10 @@ namespace Acore
             if (player == i_source || !player->HaveAtClient(i_source) || player->IsFriendlyTo(i_source))
                 return;
 
-            player->GetSession()->SendPacket(i_message);
+            if (!i_sharedMessage)
+                i_sharedMessage = std::make_shared<WorldPacket>(*i_message);
+
+            player->GetSession()->SendSharedPacket(i_sharedMessage);
         }
     };
 
@@ -19,6 +19,7 @@
 #include "Battleground.h"
 #include "CellImpl.h"
 #include "Chat.h"
+#include "CreatureGroups.h"
 #include "DisableMgr.h"
 #include "DynamicTree.h"
 #include "GameTime.h"
@@ -28,6 +29,7 @@
 #include "InstanceScript.h"
 #include "LFGMgr.h"
 #include "MapInstanced.h"
+#include "MapMgr.h"
 #include "Metric.h"
 #include "MiscPackets.h"
 #include "Object.h"
@@ -36,13 +38,19 @@
 #include "ObjectMgr.h"
 #include "Pet.h"
 #include "ScriptMgr.h"
+#include "TemporarySummon.h"
 #include "Transport.h"
 #include "VMapFactory.h"
 #include "Vehicle.h"
 #include "Weather.h"
+#include <condition_variable>
+#include <numeric>
 
 //npcbot
+#include "botaoezones.h"
+#include "botdecision.h"
 #include "botmgr.h"
+#include "botscheduler.h"
 //end npcbot
 
 union u_map_magic
@@ -63,6 +71,137 @@ static uint16 const holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 ZoneDynamicInfo::ZoneDynamicInfo() : MusicId(0), WeatherId(WEATHER_STATE_FINE),
                                      WeatherGrade(0.0f), OverrideLightId(0), LightFadeInTime(0) { }
 
+// Active cells of a continent split into regions that are updated in parallel
+struct MapRegionUpdate
+{
+    static constexpr int32 BUCKET_EMPTY = -1;
+    static constexpr int32 BUCKET_UNASSIGNED = -2;
+
+    bool collecting = false;
+    std::vector<uint32> cells;                      // active cells of this tick, marked in marked_cells/marked_cells_large
+    std::vector<std::vector<uint32>> regions;       // cells of each region, biggest regions first
+    uint32 regionCount = 0;
+
+    uint32 bucketSize = 0;                          // cells, buckets that do not touch are at least margin apart
+    uint32 bucketsPerSide = 0;
+    std::vector<int32> bucketRegions;
+    std::vector<uint32> buckets;
+    std::vector<uint32> stack;
+
+    std::vector<uint32> regionLinks;                // regions that hold linked objects are merged, see MapRegionLinker
+    std::vector<int32> regionIds;
+    std::unordered_map<ObjectGuid, uint32> linkedObjects;
+    std::unordered_map<uint32, uint32> linkedFormations;
+    bool unlinkedAccess = false;                    // scripted objects may reach any object of the map, update serially
+
+    uint32 diff = 0;
+    std::atomic<size_t> next{0};
+    std::mutex lock;
+    std::condition_variable done;
+    uint32 helpers = 0;
+    bool open = false;
+};
+
+// Merges regions of objects that access each other during update: owner, charmer, summoner, formation, victim,
+// owning player and their group (NPCBot per-map caches rely on it, see botcommon.h)
+// Scripts (ScriptName, SmartAI) keep guids of objects anywhere on the map, regions are not split if any of them is active
+struct MapRegionLinker
+{
+    explicit MapRegionLinker(MapRegionUpdate& regionUpdate) : region(0), _regionUpdate(regionUpdate) { }
+
+    uint32 FindRegion(uint32 id)
+    {
+        std::vector<uint32>& links = _regionUpdate.regionLinks;
+        while (links[id] != id)
+        {
+            links[id] = links[links[id]];
+            id = links[id];
+        }
+        return id;
+    }
+
+    void LinkRegion(uint32 other)
+    {
+        uint32 first = FindRegion(region);
+        uint32 second = FindRegion(other);
+        if (first != second)
+            _regionUpdate.regionLinks[std::max(first, second)] = std::min(first, second);
+    }
+
+    void Link(ObjectGuid guid)
+    {
+        if (!guid)
+            return;
+
+        auto itr = _regionUpdate.linkedObjects.emplace(guid, region);
+        if (!itr.second)
+            LinkRegion(itr.first->second);
+    }
+
+    void Visit(CreatureMapType& m)
+    {
+        for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+        {
+            Creature* creature = iter->GetSource();
+            //npcbot: bot scripts only reach their master's party and victims, linked below
+            if (!creature->IsNPCBotOrPet() && (creature->GetScriptId() || creature->GetAIName() == "SmartAI"))
+                _regionUpdate.unlinkedAccess = true;
+            //end npcbot
+
+            Link(creature->GetGUID());
+            Link(creature->GetOwnerGUID());
+            Link(creature->GetCharmerGUID());
+            Link(creature->GetCreatorGUID());
+            Link(creature->GetTarget());
+            if (Unit* victim = creature->GetVictim())
+                Link(victim->GetGUID());
+            if (creature->IsSummon())
+                Link(creature->ToTempSummon()->GetSummonerGUID());
+            if (CreatureGroup* formation = creature->GetFormation())
+            {
+                auto itr = _regionUpdate.linkedFormations.emplace(formation->GetId(), region);
+                if (!itr.second)
+                    LinkRegion(itr.first->second);
+            }
+            //npcbot: bots of a group heal and buff every member of that group and their pets
+            Player* ownerPlayer = creature->IsNPCBotOrPet() ? (creature->IsFreeBot() ? nullptr : creature->GetBotOwner()) :
+                creature->GetCharmerOrOwnerPlayerOrPlayerItself();
+            if (ownerPlayer)
+            {
+                Link(ownerPlayer->GetGUID());
+                if (Group const* group = ownerPlayer->GetGroup())
+                    Link(group->GetGUID());
+            }
+            //end npcbot
+        }
+    }
+
+    void Visit(GameObjectMapType& m)
+    {
+        for (GameObjectMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+        {
+            GameObject* go = iter->GetSource();
+            if (go->GetScriptId() || go->GetAIName() == "SmartGameObjectAI")
+                _regionUpdate.unlinkedAccess = true;
+
+            Link(go->GetOwnerGUID());
+        }
+    }
+
+    void Visit(DynamicObjectMapType& m)
+    {
+        for (DynamicObjectMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+            Link(iter->GetSource()->GetCasterGUID());
+    }
+
+    template<class T> void Visit(GridRefMgr<T>&) { }
+
+    uint32 region;                                  // region of the visited cell
+
+private:
+    MapRegionUpdate& _regionUpdate;
+};
+
 Map::~Map()
 {
     // UnloadAll must be called before deleting the map
@@ -84,6 +223,11 @@ Map::~Map()
 
     //MMAP::MMapFactory::createOrGetMMapMgr()->unloadMap(GetId());
     MMAP::MMapFactory::createOrGetMMapMgr()->unloadMapInstance(GetId(), i_InstanceId);
+
+    //npcbot
+    BotUpdateScheduler::OnMapUnload(this);
+    BotDecisionPipeline::OnMapUnload(this);
+    //end npcbot
 }
 
 bool Map::ExistMap(uint32 mapid, int gx, int gy)
@@ -256,6 +400,10 @@ Map::Map(uint32 id, uint32 InstanceId, uint8 SpawnMode, Map* _parent) :
     //lets initialize visibility distance for map
     Map::InitVisibilityDistance();
 
+    //npcbot
+    _botAoeZones = std::make_unique<BotAoeZoneRegistry>();
+    //end npcbot
+
     sScriptMgr->OnCreateMap(this);
 }
 
@@ -476,6 +624,10 @@ bool Map::EnsureGridLoaded(const Cell& cell)
     ASSERT(grid);
     if (!isGridObjectDataLoaded(cell.GridX(), cell.GridY()))
     {
+        MapRegionGuard guard(this);
+        if (isGridObjectDataLoaded(cell.GridX(), cell.GridY()))
+            return false;
+
         //if (!isGridObjectDataLoaded(cell.GridX(), cell.GridY()))
         //{
         LOG_DEBUG("maps", "Loading grid[{}, {}] for map {} instance {}", cell.GridX(), cell.GridY(), GetId(), i_InstanceId);
@@ -558,6 +710,8 @@ void Map::InitializeObject(GameObject*  /*obj*/)
 template<class T>
 bool Map::AddToMap(T* obj, bool checkTransport)
 {
+    MapRegionGuard guard(this);
+
     //TODO: Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -694,6 +848,12 @@ void Map::VisitNearbyCellsOfPlayer(Player* player, TypeContainerVisitor<Acore::O
             CellCoord pair(x, y);
             Cell cell(pair);
 
+            if (_regionUpdate && _regionUpdate->collecting)
+            {
+                CollectRegionCell(cell_id, cell);
+                continue;
+            }
+
             Visit(cell, largeGridVisitor);
             Visit(cell, largeWorldVisitor);
         }
@@ -730,6 +890,17 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Acore::Objec
             Cell cell(pair);
             //cell.SetNoCreate(); // in mmaps this is missing
 
+            // continent regions: cell is updated later by UpdateRegions(), large objects in it too
+            if (_regionUpdate && _regionUpdate->collecting)
+            {
+                if (!isCellMarkedLarge(cell_id))
+                {
+                    markCellLarge(cell_id);
+                    CollectRegionCell(cell_id, cell);
+                }
+                continue;
+            }
+
             Visit(cell, gridVisitor);
             Visit(cell, worldVisitor);
 
@@ -782,6 +953,17 @@ void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
     resetMarkedCells();
     resetMarkedCellsLarge();
 
+    // continents may only collect active cells here and update them afterwards as independent regions in parallel
+    bool updateRegions = CanUpdateRegions();
+    if (updateRegions)
+    {
+        if (!_regionUpdate)
+            _regionUpdate = std::make_unique<MapRegionUpdate>();
+
+        _regionUpdate->cells.clear();
+        _regionUpdate->collecting = true;
+    }
+
     Acore::ObjectUpdater updater(t_diff, false);
 
     // for creature
@@ -857,6 +1039,12 @@ void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
         }
     }
 
+    if (updateRegions)
+    {
+        _regionUpdate->collecting = false;
+        UpdateRegions(t_diff);
+    }
+
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();) // pussywizard: transports updated after VisitNearbyCellsOf, grids around are loaded, everything ok
     {
         MotionTransport* transport = *_transportsUpdateIter;
@@ -895,6 +1083,226 @@ void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
         METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
 }
 
+bool Map::CanUpdateRegions() const
+{
+    return sWorld->getBoolConfig(CONFIG_MAP_UPDATE_REGIONS) && i_mapEntry->IsContinent() && sMapMgr->GetMapUpdater()->thread_count() > 1;
+}
+
+void Map::CollectRegionCell(uint32 cellId, Cell const& cell)
+{
+    _regionUpdate->cells.push_back(cellId);
+
+    // regions never load grids themselves
+    EnsureGridLoaded(cell);
+}
+
+void Map::BuildUpdateRegions()
+{
+    MapRegionUpdate& regionUpdate = *_regionUpdate;
+
+    uint32 bucketSize = std::max<uint32>(1, uint32(std::ceil(sWorld->getIntConfig(CONFIG_MAP_UPDATE_REGIONS_MARGIN) / SIZE_OF_GRID_CELL)));
+    if (regionUpdate.bucketSize != bucketSize)
+    {
+        regionUpdate.bucketSize = bucketSize;
+        regionUpdate.bucketsPerSide = (TOTAL_NUMBER_OF_CELLS_PER_MAP + bucketSize - 1) / bucketSize;
+        regionUpdate.bucketRegions.assign(regionUpdate.bucketsPerSide * regionUpdate.bucketsPerSide, MapRegionUpdate::BUCKET_EMPTY);
+    }
+
+    uint32 const side = regionUpdate.bucketsPerSide;
+    std::vector<int32>& labels = regionUpdate.bucketRegions;
+    auto getBucket = [bucketSize, side](uint32 cellId)
+    {
+        return (cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP / bucketSize) * side + (cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP) / bucketSize;
+    };
+
+    regionUpdate.buckets.clear();
+    for (uint32 cellId : regionUpdate.cells)
+    {
+        uint32 bucket = getBucket(cellId);
+        if (labels[bucket] == MapRegionUpdate::BUCKET_EMPTY)
+        {
+            labels[bucket] = MapRegionUpdate::BUCKET_UNASSIGNED;
+            regionUpdate.buckets.push_back(bucket);
+        }
+    }
+
+    // occupied buckets touching each other form a region
+    regionUpdate.regionCount = 0;
+    for (uint32 bucket : regionUpdate.buckets)
+    {
+        if (labels[bucket] != MapRegionUpdate::BUCKET_UNASSIGNED)
+            continue;
+
+        int32 region = int32(regionUpdate.regionCount++);
+        labels[bucket] = region;
+        regionUpdate.stack.push_back(bucket);
+        while (!regionUpdate.stack.empty())
+        {
+            uint32 current = regionUpdate.stack.back();
+            regionUpdate.stack.pop_back();
+
+            uint32 bx = current % side;
+            uint32 by = current / side;
+            for (uint32 ny = by ? by - 1 : 0; ny <= std::min(by + 1, side - 1); ++ny)
+            {
+                for (uint32 nx = bx ? bx - 1 : 0; nx <= std::min(bx + 1, side - 1); ++nx)
+                {
+                    uint32 neighbour = ny * side + nx;
+                    if (labels[neighbour] != MapRegionUpdate::BUCKET_UNASSIGNED)
+                        continue;
+
+                    labels[neighbour] = region;
+                    regionUpdate.stack.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    // linked objects may be far apart, their regions are updated as one
+    regionUpdate.regionLinks.resize(regionUpdate.regionCount);
+    std::iota(regionUpdate.regionLinks.begin(), regionUpdate.regionLinks.end(), 0);
+    regionUpdate.unlinkedAccess = false;
+    if (regionUpdate.regionCount > 1)
+    {
+        MapRegionLinker linker(regionUpdate);
+        TypeContainerVisitor<MapRegionLinker, GridTypeMapContainer> gridLinker(linker);
+        TypeContainerVisitor<MapRegionLinker, WorldTypeMapContainer> worldLinker(linker);
+        for (uint32 cellId : regionUpdate.cells)
+        {
+            if (regionUpdate.unlinkedAccess)
+                break;
+
+            CellCoord pair(cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP, cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+            Cell cell(pair);
+            linker.region = uint32(labels[getBucket(cellId)]);
+            Visit(cell, gridLinker);
+            Visit(cell, worldLinker);
+        }
+        regionUpdate.linkedObjects.clear();
+        regionUpdate.linkedFormations.clear();
+
+        // serial update: every region is merged into the first one
+        if (regionUpdate.unlinkedAccess)
+            std::fill(regionUpdate.regionLinks.begin(), regionUpdate.regionLinks.end(), 0);
+    }
+
+    // regions are always linked to a lower one, so its id is known by the time a region is reached
+    regionUpdate.regionIds.assign(regionUpdate.regionCount, MapRegionUpdate::BUCKET_EMPTY);
+    uint32 mergedCount = 0;
+    for (uint32 i = 0; i < regionUpdate.regionCount; ++i)
+        if (regionUpdate.regionLinks[i] == i)
+            regionUpdate.regionIds[i] = int32(mergedCount++);
+    for (uint32 i = 0; i < regionUpdate.regionCount; ++i)
+        regionUpdate.regionIds[i] = regionUpdate.regionIds[regionUpdate.regionLinks[i]];
+    regionUpdate.regionCount = mergedCount;
+
+    if (regionUpdate.regions.size() < regionUpdate.regionCount)
+        regionUpdate.regions.resize(regionUpdate.regionCount);
+    for (uint32 i = 0; i < regionUpdate.regionCount; ++i)
+        regionUpdate.regions[i].clear();
+
+    for (uint32 cellId : regionUpdate.cells)
+        regionUpdate.regions[regionUpdate.regionIds[labels[getBucket(cellId)]]].push_back(cellId);
+
+    for (uint32 bucket : regionUpdate.buckets)
+        labels[bucket] = MapRegionUpdate::BUCKET_EMPTY;
+
+    // biggest regions first so the last one to finish is small
+    std::sort(regionUpdate.regions.begin(), regionUpdate.regions.begin() + regionUpdate.regionCount,
+        [](std::vector<uint32> const& left, std::vector<uint32> const& right) { return left.size() > right.size(); });
+}
+
+void Map::UpdateRegions(uint32 t_diff)
+{
+    MapRegionUpdate& regionUpdate = *_regionUpdate;
+    BuildUpdateRegions();
+
+    regionUpdate.diff = t_diff;
+    regionUpdate.next = 0;
+
+    if (!regionUpdate.regionCount)
+        return;
+
+    // a single region is updated by map thread alone, same as a regular update
+    uint32 helpers = std::min<uint32>(sMapMgr->GetMapUpdater()->thread_count() - 1, regionUpdate.regionCount - 1);
+    if (!helpers)
+    {
+        UpdateRegionCells();
+        return;
+    }
+
+    _regionUpdateActive = true;
+    {
+        std::lock_guard<std::mutex> guard(regionUpdate.lock);
+        regionUpdate.open = true;
+    }
+
+    sMapMgr->GetMapUpdater()->schedule_region_update(*this, helpers);
+
+    UpdateRegionCells();
+
+    // helpers that did not start yet have nothing left to do and will return right away
+    {
+        std::unique_lock<std::mutex> guard(regionUpdate.lock);
+        regionUpdate.open = false;
+        while (regionUpdate.helpers > 0)
+            regionUpdate.done.wait(guard);
+    }
+    _regionUpdateActive = false;
+}
+
+void Map::UpdateRegionsHelper()
+{
+    MapRegionUpdate& regionUpdate = *_regionUpdate;
+    {
+        std::lock_guard<std::mutex> guard(regionUpdate.lock);
+        if (!regionUpdate.open)
+            return;
+
+        ++regionUpdate.helpers;
+    }
+
+    UpdateRegionCells();
+
+    std::lock_guard<std::mutex> guard(regionUpdate.lock);
+    --regionUpdate.helpers;
+    regionUpdate.done.notify_all();
+}
+
+void Map::UpdateRegionCells()
+{
+    MapRegionUpdate& regionUpdate = *_regionUpdate;
+
+    Acore::ObjectUpdater updater(regionUpdate.diff, false);
+    TypeContainerVisitor<Acore::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    TypeContainerVisitor<Acore::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    Acore::ObjectUpdater largeObjectUpdater(regionUpdate.diff, true);
+    TypeContainerVisitor<Acore::ObjectUpdater, GridTypeMapContainer  > grid_large_object_update(largeObjectUpdater);
+    TypeContainerVisitor<Acore::ObjectUpdater, WorldTypeMapContainer  > world_large_object_update(largeObjectUpdater);
+
+    for (size_t i = regionUpdate.next++; i < regionUpdate.regionCount; i = regionUpdate.next++)
+    {
+        for (uint32 cellId : regionUpdate.regions[i])
+        {
+            CellCoord pair(cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP, cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+            Cell cell(pair);
+
+            if (isCellMarked(cellId))
+            {
+                Visit(cell, grid_object_update);
+                Visit(cell, world_object_update);
+            }
+
+            if (isCellMarkedLarge(cellId))
+            {
+                Visit(cell, grid_large_object_update);
+                Visit(cell, world_large_object_update);
+            }
+        }
+    }
+}
+
 void Map::HandleDelayedVisibility()
 {
     if (i_objectsForDelayedVisibility.empty())
@@ -946,6 +1354,8 @@ void Map::AfterPlayerUnlinkFromMap()
 template<class T>
 void Map::RemoveFromMap(T* obj, bool remove)
 {
+    MapRegionGuard guard(this);
+
     bool inWorld = obj->IsInWorld() && obj->GetTypeId() >= TYPEID_UNIT && obj->GetTypeId() <= TYPEID_GAMEOBJECT;
     obj->RemoveFromWorld();
 
@@ -1092,6 +1502,7 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
 
 void Map::AddCreatureToMoveList(Creature* c)
 {
+    MapRegionGuard guard(this);
     if (c->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
         _creaturesToMove.push_back(c);
     c->_moveState = MAP_OBJECT_CELL_MOVE_ACTIVE;
@@ -1105,6 +1516,7 @@ void Map::RemoveCreatureFromMoveList(Creature* c)
 
 void Map::AddGameObjectToMoveList(GameObject* go)
 {
+    MapRegionGuard guard(this);
     if (go->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
         _gameObjectsToMove.push_back(go);
     go->_moveState = MAP_OBJECT_CELL_MOVE_ACTIVE;
@@ -1118,6 +1530,7 @@ void Map::RemoveGameObjectFromMoveList(GameObject* go)
 
 void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj)
 {
+    MapRegionGuard guard(this);
     if (dynObj->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
         _dynamicObjectsToMove.push_back(dynObj);
     dynObj->_moveState = MAP_OBJECT_CELL_MOVE_ACTIVE;
@@ -2119,6 +2532,7 @@ bool Map::GetAreaInfo(uint32 phaseMask, float x, float y, float z, uint32& flags
     int32 dgroupId;
 
     bool hasVmapAreaInfo = vmgr->GetAreaInfo(GetId(), x, y, vmap_z, vflags, vadtId, vrootId, vgroupId);
+    auto treeLock = LockDynamicTreeForRead();
     bool hasDynamicAreaInfo = _dynamicTree.GetAreaInfo(x, y, dynamic_z, phaseMask, dflags, dadtId, drootId, dgroupId);
     auto useVmap = [&]() { check_z = vmap_z; flags = vflags; adtId = vadtId; rootId = vrootId; groupId = vgroupId; };
     auto useDyn = [&]() { check_z = dynamic_z; flags = dflags; adtId = dadtId; rootId = drootId; groupId = dgroupId; };
@@ -2466,6 +2880,7 @@ bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, floa
             ignoreFlags = VMAP::ModelIgnoreFlags::M2;
         }
 
+        auto treeLock = LockDynamicTreeForRead();
         if (!_dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask, ignoreFlags))
         {
             return false;
@@ -2481,6 +2896,7 @@ bool Map::GetObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float
     G3D::Vector3 dstPos(x2, y2, z2);
 
     G3D::Vector3 resultPos;
+    auto treeLock = LockDynamicTreeForRead();
     bool result = _dynamicTree.GetObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
 
     rx = resultPos.x;
@@ -2493,6 +2909,7 @@ float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool vmap/*=tr
 {
     float h1, h2;
     h1 = GetHeight(x, y, z, vmap, maxSearchDist);
+    auto treeLock = LockDynamicTreeForRead();
     h2 = _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask);
     return std::max<float>(h1, h2);
 }
@@ -2654,6 +3071,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete(false);                            // remove or simplify at least cross referenced links
 
+    MapRegionGuard guard(this);
     i_objectsToRemove.insert(obj);
     //LOG_DEBUG("maps", "Object ({}) added to removing list.", obj->GetGUID().ToString());
 }
@@ -2666,6 +3084,7 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
     if (obj->GetTypeId() != TYPEID_UNIT && obj->GetTypeId() != TYPEID_GAMEOBJECT)
         return;
 
+    MapRegionGuard guard(this);
     std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -3325,21 +3744,25 @@ void BattlegroundMap::RemoveAllPlayers()
 
 Corpse* Map::GetCorpse(ObjectGuid const guid)
 {
+    MapRegionGuard guard(this);
     return _objectsStore.Find<Corpse>(guid);
 }
 
 Creature* Map::GetCreature(ObjectGuid const guid)
 {
+    MapRegionGuard guard(this);
     return _objectsStore.Find<Creature>(guid);
 }
 
 GameObject* Map::GetGameObject(ObjectGuid const guid)
 {
+    MapRegionGuard guard(this);
     return _objectsStore.Find<GameObject>(guid);
 }
 
 Pet* Map::GetPet(ObjectGuid const guid)
 {
+    MapRegionGuard guard(this);
     return _objectsStore.Find<Pet>(guid);
 }
 
@@ -3354,6 +3777,7 @@ Transport* Map::GetTransport(ObjectGuid guid)
 
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    MapRegionGuard guard(this);
     return _objectsStore.Find<DynamicObject>(guid);
 }
 
@@ -3376,7 +3800,10 @@ void Map::SaveCreatureRespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTi
     if (GetInstanceResetPeriod() > 0 && respawnTime - now + 5 >= GetInstanceResetPeriod())
         respawnTime = now + YEAR;
 
-    _creatureRespawnTimes[spawnId] = respawnTime;
+    {
+        MapRegionGuard guard(this);
+        _creatureRespawnTimes[spawnId] = respawnTime;
+    }
 
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_CREATURE_RESPAWN);
     stmt->SetData(0, spawnId);
@@ -3388,7 +3815,10 @@ void Map::SaveCreatureRespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTi
 
 void Map::RemoveCreatureRespawnTime(ObjectGuid::LowType spawnId)
 {
-    _creatureRespawnTimes.erase(spawnId);
+    {
+        MapRegionGuard guard(this);
+        _creatureRespawnTimes.erase(spawnId);
+    }
 
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CREATURE_RESPAWN);
     stmt->SetData(0, spawnId);
@@ -3410,7 +3840,10 @@ void Map::SaveGORespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTime)
     if (GetInstanceResetPeriod() > 0 && respawnTime - now + 5 >= GetInstanceResetPeriod())
         respawnTime = now + YEAR;
 
-    _goRespawnTimes[spawnId] = respawnTime;
+    {
+        MapRegionGuard guard(this);
+        _goRespawnTimes[spawnId] = respawnTime;
+    }
 
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_GO_RESPAWN);
     stmt->SetData(0, spawnId);
@@ -3422,7 +3855,10 @@ void Map::SaveGORespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTime)
 
 void Map::RemoveGORespawnTime(ObjectGuid::LowType spawnId)
 {
-    _goRespawnTimes.erase(spawnId);
+    {
+        MapRegionGuard guard(this);
+        _goRespawnTimes.erase(spawnId);
+    }
 
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_GO_RESPAWN);
     stmt->SetData(0, spawnId);
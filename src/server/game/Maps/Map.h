@@ -33,6 +33,7 @@
 #include "Position.h"
 #include "SharedDefines.h"
 #include "Timer.h"
+#include <atomic>
 #include <bitset>
 #include <list>
 #include <memory>
@@ -308,6 +309,26 @@ enum EncounterCreditType
     ENCOUNTER_CREDIT_CAST_SPELL     = 1,
 };
 
+struct MapRegionUpdate;
+
+//npcbot
+class BotAoeZoneRegistry;
+//end npcbot
+
+// Serializes access to map-wide containers while regions of the map are updated in parallel, no-op otherwise
+class MapRegionGuard
+{
+public:
+    explicit MapRegionGuard(Map const* map);
+    ~MapRegionGuard();
+
+private:
+    std::recursive_mutex* _lock;
+
+    MapRegionGuard(MapRegionGuard const&) = delete;
+    MapRegionGuard& operator=(MapRegionGuard const&) = delete;
+};
+
 class Map : public GridRefMgr<NGridType>
 {
     friend class MapReference;
@@ -475,8 +496,8 @@ public:
     [[nodiscard]] bool HavePlayers() const { return !m_mapRefMgr.IsEmpty(); }
     [[nodiscard]] uint32 GetPlayersCountExceptGMs() const;
 
-    void AddWorldObject(WorldObject* obj) { i_worldObjects.insert(obj); }
-    void RemoveWorldObject(WorldObject* obj) { i_worldObjects.erase(obj); }
+    void AddWorldObject(WorldObject* obj) { MapRegionGuard guard(this); i_worldObjects.insert(obj); }
+    void RemoveWorldObject(WorldObject* obj) { MapRegionGuard guard(this); i_worldObjects.erase(obj); }
 
     void SendToPlayers(WorldPacket const* data) const;
 
@@ -554,14 +575,15 @@ public:
     bool CanReachPositionAndGetValidCoords(WorldObject const* source, float &destX, float &destY, float &destZ, bool failOnCollision = true, bool failOnSlopes = true) const;
     bool CanReachPositionAndGetValidCoords(WorldObject const* source, float startX, float startY, float startZ, float &destX, float &destY, float &destZ, bool failOnCollision = true, bool failOnSlopes = true) const;
     bool CheckCollisionAndGetValidCoords(WorldObject const* source, float startX, float startY, float startZ, float &destX, float &destY, float &destZ, bool failOnCollision = true) const;
-    void Balance() { _dynamicTree.balance(); }
-    void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-    void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
-    [[nodiscard]] bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
+    void Balance() { auto treeLock = LockDynamicTreeForWrite(); _dynamicTree.balance(); }
+    void RemoveGameObjectModel(const GameObjectModel& model) { auto treeLock = LockDynamicTreeForWrite(); _dynamicTree.remove(model); }
+    void InsertGameObjectModel(const GameObjectModel& model) { auto treeLock = LockDynamicTreeForWrite(); _dynamicTree.insert(model); }
+    [[nodiscard]] bool ContainsGameObjectModel(const GameObjectModel& model) const { auto treeLock = LockDynamicTreeForRead(); return _dynamicTree.contains(model);}
     [[nodiscard]] DynamicMapTree const& GetDynamicMapTree() const { return _dynamicTree; }
     bool GetObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist);
     [[nodiscard]] float GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
     {
+        auto treeLock = LockDynamicTreeForRead();
         return _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask);
     }
     /*
@@ -570,6 +592,7 @@ public:
     [[nodiscard]] time_t GetLinkedRespawnTime(ObjectGuid guid) const;
     [[nodiscard]] time_t GetCreatureRespawnTime(ObjectGuid::LowType dbGuid) const
     {
+        MapRegionGuard guard(this);
         std::unordered_map<ObjectGuid::LowType /*dbGUID*/, time_t>::const_iterator itr = _creatureRespawnTimes.find(dbGuid);
         if (itr != _creatureRespawnTimes.end())
             return itr->second;
@@ -579,6 +602,7 @@ public:
 
     [[nodiscard]] time_t GetGORespawnTime(ObjectGuid::LowType dbGuid) const
     {
+        MapRegionGuard guard(this);
         std::unordered_map<ObjectGuid::LowType /*dbGUID*/, time_t>::const_iterator itr = _goRespawnTimes.find(dbGuid);
         if (itr != _goRespawnTimes.end())
             return itr->second;
@@ -632,16 +656,19 @@ public:
     inline ObjectGuid::LowType GenerateLowGuid()
     {
         static_assert(ObjectGuidTraits<high>::MapSpecific, "Only map specific guid can be generated in Map context");
+        MapRegionGuard guard(this);
         return GetGuidSequenceGenerator<high>().Generate();
     }
 
     void AddUpdateObject(Object* obj)
     {
+        MapRegionGuard guard(this);
         _updateObjects.insert(obj);
     }
 
     void RemoveUpdateObject(Object* obj)
     {
+        MapRegionGuard guard(this);
         _updateObjects.erase(obj);
     }
 
@@ -650,6 +677,20 @@ public:
         return m_activeNonPlayers.size();
     }
 
+    // Duration of the last threaded update in microseconds, MapUpdater dispatches expensive maps first
+    [[nodiscard]] uint32 GetLastUpdateCost() const { return _lastUpdateCost; }
+    void SetLastUpdateCost(uint32 cost) { _lastUpdateCost = cost; }
+
+    // Continent regions are being updated in parallel, map-wide containers must be accessed under MapRegionGuard
+    [[nodiscard]] bool IsUpdatingRegions() const { return _regionUpdateActive.load(std::memory_order_relaxed); }
+    std::recursive_mutex& GetRegionUpdateLock() const { return _regionUpdateLock; }
+    // Called by map update threads helping with parallel region update
+    void UpdateRegionsHelper();
+
+    //npcbot
+    [[nodiscard]] BotAoeZoneRegistry* GetBotAoeZones() const { return _botAoeZones.get(); }
+    //end npcbot
+
     virtual std::string GetDebugInfo() const;
 
 private:
@@ -742,6 +783,34 @@ private:
     std::map<WorldObject*, bool> i_objectsToSwitch;
     std::unordered_set<WorldObject*> i_worldObjects;
 
+    uint32 _lastUpdateCost{0};
+
+    // Parallel update of continent regions
+    bool CanUpdateRegions() const;
+    void CollectRegionCell(uint32 cellId, Cell const& cell);
+    void BuildUpdateRegions();
+    void UpdateRegions(uint32 t_diff);
+    void UpdateRegionCells();
+
+    std::unique_ptr<MapRegionUpdate> _regionUpdate;
+    std::atomic<bool> _regionUpdateActive{false};
+    mutable std::recursive_mutex _regionUpdateLock;
+
+    //npcbot
+    std::unique_ptr<BotAoeZoneRegistry> _botAoeZones;
+    //end npcbot
+
+    // Dynamic tree is read by every LoS and height check, so regions share it and only lock it exclusively to change models
+    mutable std::shared_mutex _dynamicTreeLock;
+    std::shared_lock<std::shared_mutex> LockDynamicTreeForRead() const
+    {
+        return IsUpdatingRegions() ? std::shared_lock<std::shared_mutex>(_dynamicTreeLock) : std::shared_lock<std::shared_mutex>();
+    }
+    std::unique_lock<std::shared_mutex> LockDynamicTreeForWrite() const
+    {
+        return IsUpdatingRegions() ? std::unique_lock<std::shared_mutex>(_dynamicTreeLock) : std::unique_lock<std::shared_mutex>();
+    }
+
     typedef std::multimap<time_t, ScriptAction> ScriptScheduleMap;
     ScriptScheduleMap m_scriptSchedule;
 
@@ -754,11 +823,13 @@ private:
 
     void AddToActiveHelper(WorldObject* obj)
     {
+        MapRegionGuard guard(this);
         m_activeNonPlayers.insert(obj);
     }
 
     void RemoveFromActiveHelper(WorldObject* obj)
     {
+        MapRegionGuard guard(this);
         // Map::Update for active object in proccess
         if (m_activeNonPlayersIter != m_activeNonPlayers.end())
         {
@@ -800,6 +871,18 @@ private:
     std::unordered_set<Object*> _updateObjects;
 };
 
+inline MapRegionGuard::MapRegionGuard(Map const* map) : _lock(map->IsUpdatingRegions() ? &map->GetRegionUpdateLock() : nullptr)
+{
+    if (_lock)
+        _lock->lock();
+}
+
+inline MapRegionGuard::~MapRegionGuard()
+{
+    if (_lock)
+        _lock->unlock();
+}
+
 enum InstanceResetMethod
 {
     INSTANCE_RESET_ALL,                 // reset all option under portrait, resets only normal 5-mans
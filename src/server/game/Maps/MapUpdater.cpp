@@ -20,57 +20,101 @@
 #include "LFGMgr.h"
 #include "Map.h"
 #include "Metric.h"
+#include <chrono>
+#include <limits>
+
+enum UpdateRequestType
+{
+    UPDATE_REQUEST_MAP,
+    UPDATE_REQUEST_MAP_REGIONS,
+    UPDATE_REQUEST_LFG
+};
 
 class UpdateRequest
 {
 public:
-    UpdateRequest() = default;
+    explicit UpdateRequest(UpdateRequestType type) : m_type(type) { }
     virtual ~UpdateRequest() = default;
 
     virtual void call() = 0;
+
+    UpdateRequestType GetType() const { return m_type; }
+
+private:
+    UpdateRequestType m_type;
 };
 
 class MapUpdateRequest : public UpdateRequest
 {
 public:
-    MapUpdateRequest(Map& m, MapUpdater& u, uint32 d, uint32 sd)
-        : m_map(m), m_updater(u), m_diff(d), s_diff(sd)
+    explicit MapUpdateRequest(MapUpdater& u) : UpdateRequest(UPDATE_REQUEST_MAP), m_map(nullptr), m_updater(u), m_diff(0), s_diff(0) { }
+
+    void Reset(Map& m, uint32 d, uint32 sd)
     {
+        m_map = &m;
+        m_diff = d;
+        s_diff = sd;
     }
 
     void call() override
     {
-        METRIC_TIMER("map_update_time_diff", METRIC_TAG("map_id", std::to_string(m_map.GetId())));
-        m_map.Update(m_diff, s_diff);
-        m_updater.update_finished();
+        auto start = std::chrono::steady_clock::now();
+        {
+            METRIC_TIMER("map_update_time_diff", METRIC_TAG("map_id", std::to_string(m_map->GetId())));
+            m_map->Update(m_diff, s_diff);
+        }
+        m_map->SetLastUpdateCost(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+        m_updater.update_finished(this);
     }
 
 private:
-    Map& m_map;
+    Map* m_map;
     MapUpdater& m_updater;
     uint32 m_diff;
     uint32 s_diff;
 };
 
+class MapRegionUpdateRequest : public UpdateRequest
+{
+public:
+    explicit MapRegionUpdateRequest(MapUpdater& u) : UpdateRequest(UPDATE_REQUEST_MAP_REGIONS), m_map(nullptr), m_updater(u) { }
+
+    void Reset(Map& m) { m_map = &m; }
+
+    void call() override
+    {
+        m_map->UpdateRegionsHelper();
+        m_updater.update_finished(this);
+    }
+
+private:
+    Map* m_map;
+    MapUpdater& m_updater;
+};
+
 class LFGUpdateRequest : public UpdateRequest
 {
 public:
-    LFGUpdateRequest(MapUpdater& u, uint32 d) : m_updater(u), m_diff(d) {}
+    explicit LFGUpdateRequest(MapUpdater& u) : UpdateRequest(UPDATE_REQUEST_LFG), m_updater(u), m_diff(0) { }
+
+    void Reset(uint32 d) { m_diff = d; }
 
     void call() override
     {
         sLFGMgr->Update(m_diff, 1);
-        m_updater.update_finished();
+        m_updater.update_finished(this);
     }
 private:
     MapUpdater& m_updater;
     uint32 m_diff;
 };
 
-MapUpdater::MapUpdater(): pending_requests(0)
+MapUpdater::MapUpdater(): _sequence(0), _dispatching(false), _lfgRequest(std::make_unique<LFGUpdateRequest>(*this)), _cancelationToken(false), pending_requests(0)
 {
 }
 
+MapUpdater::~MapUpdater() = default;
+
 void MapUpdater::activate(size_t num_threads)
 {
     _workerThreads.reserve(num_threads);
@@ -82,11 +126,14 @@ void MapUpdater::activate(size_t num_threads)
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
     wait();
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _cancelationToken = true;
+    }
+
+    _queueCondition.notify_all();
 
     for (auto& thread : _workerThreads)
     {
@@ -101,9 +148,16 @@ void MapUpdater::wait()
 {
     std::unique_lock<std::mutex> guard(_lock);
 
+    // release everything scheduled so far, requests scheduled from now on (instances) are taken right away
+    _dispatching = true;
+    _queueCondition.notify_all();
+
     while (pending_requests > 0)
         _condition.wait(guard);
 
+    _dispatching = false;
+    _sequence = 0;
+
     guard.unlock();
 }
 
@@ -111,18 +165,62 @@ void MapUpdater::schedule_update(Map& map, uint32 diff, uint32 s_diff)
 {
     std::lock_guard<std::mutex> guard(_lock);
 
-    ++pending_requests;
+    MapUpdateRequest* request;
+    if (_freeMapRequests.empty())
+    {
+        _mapRequests.push_back(std::make_unique<MapUpdateRequest>(*this));
+        request = _mapRequests.back().get();
+    }
+    else
+    {
+        request = _freeMapRequests.back();
+        _freeMapRequests.pop_back();
+    }
 
-    _queue.Push(new MapUpdateRequest(map, *this, diff, s_diff));
+    request->Reset(map, diff, s_diff);
+    Push(request, map.GetLastUpdateCost());
 }
 
 void MapUpdater::schedule_lfg_update(uint32 diff)
 {
     std::lock_guard<std::mutex> guard(_lock);
 
+    // scheduled once per tick, goes first so it is processed from the very beginning
+    _lfgRequest->Reset(diff);
+    Push(_lfgRequest.get(), std::numeric_limits<uint32>::max());
+}
+
+void MapUpdater::schedule_region_update(Map& map, uint32 helpers)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    for (uint32 i = 0; i < helpers; ++i)
+    {
+        MapRegionUpdateRequest* request;
+        if (_freeRegionRequests.empty())
+        {
+            _regionRequests.push_back(std::make_unique<MapRegionUpdateRequest>(*this));
+            request = _regionRequests.back().get();
+        }
+        else
+        {
+            request = _freeRegionRequests.back();
+            _freeRegionRequests.pop_back();
+        }
+
+        request->Reset(map);
+        Push(request, std::numeric_limits<uint32>::max());
+    }
+}
+
+void MapUpdater::Push(UpdateRequest* request, uint32 cost)
+{
     ++pending_requests;
 
-    _queue.Push(new LFGUpdateRequest(*this, diff));
+    _queue.push({ cost, _sequence++, request });
+
+    if (_dispatching)
+        _queueCondition.notify_one();
 }
 
 bool MapUpdater::activated()
@@ -130,10 +228,22 @@ bool MapUpdater::activated()
     return _workerThreads.size() > 0;
 }
 
-void MapUpdater::update_finished()
+void MapUpdater::update_finished(UpdateRequest* request)
 {
     std::lock_guard<std::mutex> lock(_lock);
 
+    switch (request->GetType())
+    {
+        case UPDATE_REQUEST_MAP:
+            _freeMapRequests.push_back(static_cast<MapUpdateRequest*>(request));
+            break;
+        case UPDATE_REQUEST_MAP_REGIONS:
+            _freeRegionRequests.push_back(static_cast<MapRegionUpdateRequest*>(request));
+            break;
+        default:
+            break;
+    }
+
     --pending_requests;
 
     _condition.notify_all();
@@ -149,12 +259,17 @@ void MapUpdater::WorkerThread()
     {
         UpdateRequest* request = nullptr;
 
-        _queue.WaitAndPop(request);
-        if (_cancelationToken)
-            return;
+        {
+            std::unique_lock<std::mutex> guard(_lock);
 
-        request->call();
+            _queueCondition.wait(guard, [this] { return _cancelationToken || (_dispatching && !_queue.empty()); });
+            if (_cancelationToken)
+                return;
 
-        delete request;
+            request = _queue.top().request;
+            _queue.pop();
+        }
+
+        request->call();
     }
 }
@@ -19,38 +19,71 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Define.h"
-#include "PCQueue.h"
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <queue>
 #include <thread>
+#include <vector>
 
 class Map;
 class UpdateRequest;
+class MapUpdateRequest;
+class MapRegionUpdateRequest;
+class LFGUpdateRequest;
 
 class MapUpdater
 {
 public:
     MapUpdater();
-    ~MapUpdater() = default;
+    ~MapUpdater();
 
     void schedule_update(Map& map, uint32 diff, uint32 s_diff);
     void schedule_lfg_update(uint32 diff);
+    // helpers join a map thread that is updating its regions, they go before everything else
+    void schedule_region_update(Map& map, uint32 helpers);
     void wait();
     void activate(size_t num_threads);
     void deactivate();
     bool activated();
-    void update_finished();
+    size_t thread_count() const { return _workerThreads.size(); }
+    void update_finished(UpdateRequest* request);
 
 private:
     void WorkerThread();
+    void Push(UpdateRequest* request, uint32 cost);
 
-    ProducerConsumerQueue<UpdateRequest*> _queue;
+    // Requests are ordered by cost of their previous update, most expensive first
+    struct QueuedRequest
+    {
+        uint32 cost;
+        uint32 sequence;
+        UpdateRequest* request;
+
+        bool operator<(QueuedRequest const& right) const
+        {
+            return cost != right.cost ? cost < right.cost : sequence > right.sequence;
+        }
+    };
+
+    std::priority_queue<QueuedRequest> _queue;
+    uint32 _sequence;
+    // Workers only take requests after wait() is called, so all maps of a tick are ordered together
+    bool _dispatching;
+
+    std::vector<std::unique_ptr<MapUpdateRequest>> _mapRequests;
+    std::vector<MapUpdateRequest*> _freeMapRequests;
+    std::vector<std::unique_ptr<MapRegionUpdateRequest>> _regionRequests;
+    std::vector<MapRegionUpdateRequest*> _freeRegionRequests;
+    std::unique_ptr<LFGUpdateRequest> _lfgRequest;
 
     std::vector<std::thread> _workerThreads;
     std::atomic<bool> _cancelationToken;
 
     std::mutex _lock;
     std::condition_variable _condition;
+    std::condition_variable _queueCondition;
     size_t pending_requests;
 };
 
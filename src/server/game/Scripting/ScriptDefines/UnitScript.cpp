@@ -203,6 +203,11 @@ bool ScriptMgr::OnBuildValuesUpdate(Unit const* unit, uint8 updateType, ByteBuff
     return false;
 }
 
+bool ScriptMgr::HasBuildValuesUpdateHooks()
+{
+    return !ScriptRegistry<UnitScript>::ScriptPointerList.empty();
+}
+
 void ScriptMgr::OnUnitUpdate(Unit* unit, uint32 diff)
 {
     ExecuteScript<UnitScript>([&](UnitScript* script)
@@ -52,6 +52,7 @@
 #include <zlib.h>
 
 //npcbot
+#include "botdatamgr.h"
 #include "botmgr.h"
 //end npcbot
 
@@ -209,9 +210,25 @@ ObjectGuid::LowType WorldSession::GetGuidLow() const
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
 {
-    if (!m_Socket)
+    if (!CanSendPacket(packet))
         return;
 
+    m_Socket->SendPacket(*packet);
+}
+
+void WorldSession::SendSharedPacket(std::shared_ptr<WorldPacket const> const& packet)
+{
+    if (!CanSendPacket(packet.get()))
+        return;
+
+    m_Socket->SendSharedPacket(packet);
+}
+
+bool WorldSession::CanSendPacket(WorldPacket const* packet)
+{
+    if (!m_Socket)
+        return false;
+
 #if defined(ACORE_DEBUG)
     // Code for network use statistic
     static uint64 sendPacketCount = 0;
@@ -248,12 +265,7 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     }
 #endif                                                      // !ACORE_DEBUG
 
-    if (!sScriptMgr->CanPacketSend(this, *packet))
-    {
-        return;
-    }
-
-    m_Socket->SendPacket(*packet);
+    return sScriptMgr->CanPacketSend(this, *packet);
 }
 
 /// Add an incoming packet to the queue
@@ -579,6 +591,7 @@ void WorldSession::LogoutPlayer(bool save)
     if (_player->HaveBot() && _player->GetGroup() && !_player->GetGroup()->isRaidGroup() && !_player->GetGroup()->isLFGGroup() && m_Socket && sWorld->getBoolConfig(CONFIG_LEAVE_GROUP_ON_LOGOUT))
         _player->GetBotMgr()->RemoveAllBotsFromGroup();
     _player->RemoveAllBots();
+    BotDataMgr::SaveNpcBotData(_player->GetGUID().GetCounter());
     //end npcbots
 
     if (_player)
@@ -344,6 +344,8 @@ public:
     void WriteMovementInfo(WorldPacket* data, MovementInfo* mi);
 
     void SendPacket(WorldPacket const* packet);
+    // Packet body is shared with other sessions and must not be modified after this call
+    void SendSharedPacket(std::shared_ptr<WorldPacket const> const& packet);
     void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
     void SendNotification(uint32 string_id, ...);
     void SendPetNameInvalid(uint32 error, std::string const& name, DeclinedName* declinedName);
@@ -1125,6 +1127,8 @@ private:
 
     bool recoveryItem(Item* pItem);
 
+    bool CanSendPacket(WorldPacket const* packet);
+
     // logging helper
     void LogUnexpectedOpcode(WorldPacket* packet, char const* status, const char* reason);
     void LogUnprocessedTail(WorldPacket* packet);
@@ -34,8 +34,12 @@
 
 using boost::asio::ip::tcp;
 
+// shared broadcast bodies from this size on are written straight from the packet instead of being copied to send buffer
+constexpr std::size_t SHARED_PACKET_GATHER_SIZE = 1024;
+
 WorldSocket::WorldSocket(tcp::socket&& socket)
-    : Socket(std::move(socket)), _OverSpeedPings(0), _worldSession(nullptr), _authed(false), _sendBufferSize(4096)
+    : Socket(std::move(socket)), _OverSpeedPings(0), _worldSession(nullptr), _authed(false), _sendBufferSize(4096), _queuedSendSize(0),
+    _sendCoalescingWindow(Milliseconds::zero())
 {
     Acore::Crypto::GetRandomBytes(_authSeed);
     _headerBuffer.Resize(sizeof(ClientPktHeader));
@@ -80,49 +84,84 @@ void WorldSocket::CheckIpCallback(PreparedQueryResult result)
 }
 
 bool WorldSocket::Update()
+{
+    // while packets keep coming they are held for a short window to leave in fewer, larger writes
+    if (_sendCoalescingWindow == Milliseconds::zero() || !IsOpen() || _queuedSendSize >= _sendBufferSize || std::chrono::steady_clock::now() >= _nextSendTime)
+        if (SendQueuedPackets() && _sendCoalescingWindow != Milliseconds::zero())
+            _nextSendTime = std::chrono::steady_clock::now() + _sendCoalescingWindow;
+
+    if (!BaseSocket::Update())
+        return false;
+
+    _queryProcessor.ProcessReadyCallbacks();
+
+    return true;
+}
+
+bool WorldSocket::SendQueuedPackets()
 {
     EncryptablePacket* queued;
-    MessageBuffer buffer(_sendBufferSize);
+    std::shared_ptr<MessageBuffer> buffer;
+    std::size_t bufferQueuedSize = 0;
+    bool sent = false;
+
+    // send buffer is queued as views of its filled parts, so it can keep filling up after a packet body was queued in between
+    auto queueBuffer = [&]()
+    {
+        if (buffer && buffer->GetActiveSize() > bufferQueuedSize)
+        {
+            QueuePacket(buffer, buffer->GetBasePointer() + bufferQueuedSize, buffer->GetActiveSize() - bufferQueuedSize);
+            bufferQueuedSize = buffer->GetActiveSize();
+        }
+    };
+
     while (_bufferQueue.Dequeue(queued))
     {
-        ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
+        WorldPacket const& packet = queued->GetPacket();
+        _queuedSendSize -= packet.size();
+        sent = true;
+
+        ServerPktHeader header(packet.size() + 2, packet.GetOpcode());
         if (queued->NeedsEncryption())
             _authCrypt.EncryptSend(header.header, header.getHeaderLength());
 
-        if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
-        {
-            QueuePacket(std::move(buffer));
-            buffer.Resize(_sendBufferSize);
-        }
+        // packets larger than send buffer and big shared bodies are not copied, header and body go out in one gathered write
+        bool gather = packet.size() + header.getHeaderLength() > _sendBufferSize ||
+            (queued->GetSharedPacket() && packet.size() >= SHARED_PACKET_GATHER_SIZE);
 
-        if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
+        std::size_t copySize = header.getHeaderLength() + (gather ? 0 : packet.size());
+        if (!buffer || buffer->GetRemainingSpace() < copySize)
         {
-            buffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                buffer.Write(queued->contents(), queued->size());
+            queueBuffer();
+            buffer = std::make_shared<MessageBuffer>(_sendBufferSize);
+            bufferQueuedSize = 0;
         }
-        else    // single packet larger than 4096 bytes
+
+        buffer->Write(header.header, header.getHeaderLength());
+
+        if (!gather)
         {
-            MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
-            packetBuffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                packetBuffer.Write(queued->contents(), queued->size());
+            if (!packet.empty())
+                buffer->Write(packet.contents(), packet.size());
 
-            QueuePacket(std::move(packetBuffer));
+            delete queued;
+            continue;
         }
 
-        delete queued;
-    }
-
-    if (buffer.GetActiveSize() > 0)
-        QueuePacket(std::move(buffer));
+        queueBuffer();
 
-    if (!BaseSocket::Update())
-        return false;
+        if (std::shared_ptr<WorldPacket const> const& sharedPacket = queued->GetSharedPacket())
+        {
+            QueuePacket(sharedPacket, sharedPacket->contents(), sharedPacket->size());
+            delete queued;
+        }
+        else
+            QueuePacket(std::shared_ptr<EncryptablePacket const>(queued), packet.contents(), packet.size());
+    }
 
-    _queryProcessor.ProcessReadyCallbacks();
+    queueBuffer();
 
-    return true;
+    return sent;
 }
 
 void WorldSocket::HandleSendAuthSession()
@@ -427,6 +466,19 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     if (sPacketLog->CanLogPacket())
         sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
+    _queuedSendSize += packet.size();
+    _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
+}
+
+void WorldSocket::SendSharedPacket(std::shared_ptr<WorldPacket const> const& packet)
+{
+    if (!IsOpen())
+        return;
+
+    if (sPacketLog->CanLogPacket())
+        sPacketLog->LogPacket(*packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+
+    _queuedSendSize += packet->size();
     _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
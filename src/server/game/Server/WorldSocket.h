@@ -30,19 +30,29 @@
 
 using boost::asio::ip::tcp;
 
-class EncryptablePacket : public WorldPacket
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt)
+    EncryptablePacket(WorldPacket const& packet, bool encrypt) : _ownPacket(packet), _encrypt(encrypt)
     {
         SocketQueueLink.store(nullptr, std::memory_order_relaxed);
     }
 
+    // Body is shared with other recipients of a broadcast and never modified, only the header is written per socket
+    EncryptablePacket(std::shared_ptr<WorldPacket const> packet, bool encrypt) : _sharedPacket(std::move(packet)), _encrypt(encrypt)
+    {
+        SocketQueueLink.store(nullptr, std::memory_order_relaxed);
+    }
+
+    WorldPacket const& GetPacket() const { return _sharedPacket ? *_sharedPacket : _ownPacket; }
+    std::shared_ptr<WorldPacket const> const& GetSharedPacket() const { return _sharedPacket; }
     bool NeedsEncryption() const { return _encrypt; }
 
     std::atomic<EncryptablePacket*> SocketQueueLink;
 
 private:
+    WorldPacket _ownPacket;
+    std::shared_ptr<WorldPacket const> _sharedPacket;
     bool _encrypt;
 };
 
@@ -79,8 +89,10 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    void SendSharedPacket(std::shared_ptr<WorldPacket const> const& packet);
 
     void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
+    void SetSendCoalescingWindow(Milliseconds window) { _sendCoalescingWindow = window; }
 
 protected:
     void OnClose() override;
@@ -99,6 +111,9 @@ protected:
 private:
     void CheckIpCallback(PreparedQueryResult result);
 
+    /// moves queued packets to socket write queue, returns false if there were none
+    bool SendQueuedPackets();
+
     /// writes network.opcode log
     /// accessing WorldSession is not threadsafe, only do it when holding _worldSessionLock
     void LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex> const& guard) const;
@@ -127,6 +142,9 @@ private:
     MessageBuffer _packetBuffer;
     MPSCQueue<EncryptablePacket, &EncryptablePacket::SocketQueueLink> _bufferQueue;
     std::size_t _sendBufferSize;
+    std::atomic<std::size_t> _queuedSendSize;
+    Milliseconds _sendCoalescingWindow;
+    TimePoint _nextSendTime;
 
     QueryCallbackProcessor _queryProcessor;
     std::string _ipCountry;
@@ -28,6 +28,7 @@ public:
     void SocketAdded(std::shared_ptr<WorldSocket> sock) override
     {
         sock->SetSendBufferSize(sWorldSocketMgr.GetApplicationSendBufferSize());
+        sock->SetSendCoalescingWindow(sWorldSocketMgr.GetSendCoalescingWindow());
         sScriptMgr->OnSocketOpen(sock);
     }
 
@@ -38,7 +39,8 @@ public:
 };
 
 WorldSocketMgr::WorldSocketMgr() :
-    BaseSocketMgr(), _socketSystemSendBufferSize(-1), _socketApplicationSendBufferSize(65536), _tcpNoDelay(true)
+    BaseSocketMgr(), _socketSystemSendBufferSize(-1), _socketApplicationSendBufferSize(65536),
+    _sendCoalescingWindow(Milliseconds::zero()), _tcpNoDelay(true)
 {
 }
 
@@ -65,6 +67,8 @@ bool WorldSocketMgr::StartWorldNetwork(Acore::Asio::IoContext& ioContext, std::s
         return false;
     }
 
+    _sendCoalescingWindow = Milliseconds(std::max<int32>(0, sConfigMgr->GetOption<int32>("Network.SendCoalescingWindow", 0)));
+
     if (!BaseSocketMgr::StartNetwork(ioContext, bindIp, port, threadCount))
         return false;
 
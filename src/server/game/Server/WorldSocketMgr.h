@@ -23,6 +23,7 @@
 #ifndef __WORLDSOCKETMGR_H
 #define __WORLDSOCKETMGR_H
 
+#include "Duration.h"
 #include "SocketMgr.h"
 
 class WorldSocket;
@@ -44,6 +45,7 @@ public:
     void OnSocketOpen(tcp::socket&& sock, uint32 threadIndex) override;
 
     std::size_t GetApplicationSendBufferSize() const { return _socketApplicationSendBufferSize; }
+    Milliseconds GetSendCoalescingWindow() const { return _sendCoalescingWindow; }
 
 protected:
     WorldSocketMgr();
@@ -58,6 +60,7 @@ protected:
 private:
     int32 _socketSystemSendBufferSize;
     int32 _socketApplicationSendBufferSize;
+    Milliseconds _sendCoalescingWindow;
     bool _tcpNoDelay;
 };
 
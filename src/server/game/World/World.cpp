@@ -1341,6 +1341,15 @@ void World::LoadConfigSettings(bool reload)
     _bool_configs[CONFIG_SHOW_MUTE_IN_WORLD]         = sConfigMgr->GetOption<bool>("ShowMuteInWorld", false);
     _bool_configs[CONFIG_SHOW_BAN_IN_WORLD]          = sConfigMgr->GetOption<bool>("ShowBanInWorld", false);
     _int_configs[CONFIG_NUMTHREADS]                  = sConfigMgr->GetOption<int32>("MapUpdate.Threads", 1);
+
+    // Parallel update of continent regions
+    _bool_configs[CONFIG_MAP_UPDATE_REGIONS]         = sConfigMgr->GetOption<bool>("MapUpdate.Regions.Enable", false);
+    _int_configs[CONFIG_MAP_UPDATE_REGIONS_MARGIN]   = sConfigMgr->GetOption<int32>("MapUpdate.Regions.Margin", int32(2 * MAX_VISIBILITY_DISTANCE));
+    if (_int_configs[CONFIG_MAP_UPDATE_REGIONS_MARGIN] < int32(2 * MAX_VISIBILITY_DISTANCE))
+    {
+        LOG_ERROR("server.loading", "MapUpdate.Regions.Margin can't be less than {}", int32(2 * MAX_VISIBILITY_DISTANCE));
+        _int_configs[CONFIG_MAP_UPDATE_REGIONS_MARGIN] = int32(2 * MAX_VISIBILITY_DISTANCE);
+    }
     _int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetOption<int32>("Command.LookupMaxResults", 0);
 
     // Warden
@@ -22,18 +22,44 @@
 #include "MessageBuffer.h"
 #include <atomic>
 #include <boost/asio/ip/tcp.hpp>
+#include <deque>
 #include <functional>
 #include <memory>
-#include <queue>
 #include <type_traits>
+#include <vector>
 
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+#define WRITE_GATHER_MAX_BUFFERS 64
 #ifdef BOOST_ASIO_HAS_IOCP
 #define AC_SOCKET_USE_IOCP
 #endif
 
+/// Queued outgoing data, either owned by the socket or a view of data kept alive by its owner until written
+class SocketWriteBuffer
+{
+public:
+    explicit SocketWriteBuffer(MessageBuffer&& buffer) : _buffer(std::move(buffer)), _data(_buffer.GetReadPointer()), _size(_buffer.GetActiveSize()) { }
+
+    SocketWriteBuffer(std::shared_ptr<void const> owner, uint8 const* data, std::size_t size) : _buffer(0), _owner(std::move(owner)), _data(data), _size(size) { }
+
+    uint8 const* GetReadPointer() const { return _data; }
+    std::size_t GetActiveSize() const { return _size; }
+
+    void ReadCompleted(std::size_t bytes)
+    {
+        _data += bytes;
+        _size -= bytes;
+    }
+
+private:
+    MessageBuffer _buffer;
+    std::shared_ptr<void const> _owner;
+    uint8 const* _data;
+    std::size_t _size;
+};
+
 template<class T>
 class Socket : public std::enable_shared_from_this<T>
 {
@@ -113,7 +139,17 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.emplace_back(std::move(buffer));
+
+#ifdef AC_SOCKET_USE_IOCP
+        AsyncProcessQueue();
+#endif
+    }
+
+    /// Queues data without copying it, owner is released once all of it is written
+    void QueuePacket(std::shared_ptr<void const> owner, uint8 const* data, std::size_t size)
+    {
+        _writeQueue.emplace_back(std::move(owner), data, size);
 
 #ifdef AC_SOCKET_USE_IOCP
         AsyncProcessQueue();
@@ -154,8 +190,7 @@ protected:
         _isWritingAsync = true;
 
 #ifdef AC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        _socket.async_write_some(GatherWriteBuffers(), std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -175,6 +210,37 @@ protected:
     }
 
 private:
+    /// Collects queued buffers for a single scatter/gather write
+    std::vector<boost::asio::const_buffer> const& GatherWriteBuffers()
+    {
+        _gatherBuffers.clear();
+        for (SocketWriteBuffer const& buffer : _writeQueue)
+        {
+            _gatherBuffers.emplace_back(buffer.GetReadPointer(), buffer.GetActiveSize());
+            if (_gatherBuffers.size() == WRITE_GATHER_MAX_BUFFERS)
+                break;
+        }
+
+        return _gatherBuffers;
+    }
+
+    /// Drops fully written buffers from the queue
+    void WriteCompleted(std::size_t bytes)
+    {
+        while (bytes && !_writeQueue.empty())
+        {
+            SocketWriteBuffer& buffer = _writeQueue.front();
+            if (bytes < buffer.GetActiveSize())
+            {
+                buffer.ReadCompleted(bytes);
+                return;
+            }
+
+            bytes -= buffer.GetActiveSize();
+            _writeQueue.pop_front();
+        }
+    }
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -193,10 +259,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            WriteCompleted(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -220,12 +283,11 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        std::vector<boost::asio::const_buffer> const& buffers = GatherWriteBuffers();
+        std::size_t bytesToSend = boost::asio::buffer_size(buffers);
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(buffers, error);
 
         if (error)
         {
@@ -234,7 +296,7 @@ private:
                 return AsyncProcessQueue();
             }
 
-            _writeQueue.pop();
+            _writeQueue.pop_front();
 
             if (_closing && _writeQueue.empty())
             {
@@ -245,7 +307,7 @@ private:
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            _writeQueue.pop_front();
 
             if (_closing && _writeQueue.empty())
             {
@@ -256,11 +318,11 @@ private:
         }
         else if (bytesSent < bytesToSend) // now n > 0
         {
-            queuedMessage.ReadCompleted(bytesSent);
+            WriteCompleted(bytesSent);
             return AsyncProcessQueue();
         }
 
-        _writeQueue.pop();
+        WriteCompleted(bytesSent);
 
         if (_closing && _writeQueue.empty())
         {
@@ -277,7 +339,8 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<SocketWriteBuffer> _writeQueue;
+    std::vector<boost::asio::const_buffer> _gatherBuffers;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;